@@ -11,7 +11,7 @@
 
 //==============================================================================
 LModelAudioProcessorEditor::LModelAudioProcessorEditor(LModelAudioProcessor& p)
-	: AudioProcessorEditor(&p), audioProcessor(p), meterUI(&p.limiter)
+	: AudioProcessorEditor(&p), audioProcessor(p), meterUI(&p.limiter), historyView(&p.limiter)
 {
 	// Make sure that before the constructor has finished, you've set the
 	// editor's size to whatever you need it to be.
@@ -20,8 +20,8 @@ LModelAudioProcessorEditor::LModelAudioProcessorEditor(LModelAudioProcessor& p)
 	setOpaque(false);  // ڱ߿
 
 	//setResizeLimits(64 * 11, 64 * 5, 10000, 10000); // СΪ300x200Ϊ800x600
-	setSize(64 * 5, 64 * 4);
-	setResizeLimits(64 * 5, 64 * 4, 64 * 13, 64 * 4);
+	setSize(64 * 11, 64 * 4);
+	setResizeLimits(64 * 10, 64 * 4, 64 * 14, 64 * 4);
 
 	//constrainer.setFixedAspectRatio(11.0 / 4.0);  // Ϊ16:9
 	//setConstrainer(&constrainer);  // 󶨴ڵĿ
@@ -44,11 +44,49 @@ LModelAudioProcessorEditor::LModelAudioProcessorEditor(LModelAudioProcessor& p)
 	K_Output.setText("output", "dB");
 	K_Output.ParamLink(audioProcessor.GetParams(), "output");
 	addAndMakeVisible(K_Output);
+	K_Adaptive.setText("adaptive", "%");
+	K_Adaptive.ParamLink(audioProcessor.GetParams(), "adaptive");
+	addAndMakeVisible(K_Adaptive);
+	B_Smooth.setName("smooth");
+	B_Smooth.ParamLink(audioProcessor.GetParams(), "smooth");
+	addAndMakeVisible(B_Smooth);
+	C_Economy.addItem("eco off", 1);
+	C_Economy.addItem("eco 4", 2);
+	C_Economy.addItem("eco 8", 3);
+	C_Economy.addItem("eco 16", 4);
+	C_Economy.addItem("eco 32", 5);
+	C_Economy.ParamLink(audioProcessor.GetParams(), "economy");
+	addAndMakeVisible(C_Economy);
+	B_TwoStage.setName("2-stage");
+	B_TwoStage.ParamLink(audioProcessor.GetParams(), "twostage");
+	addAndMakeVisible(B_TwoStage);
+	K_LevelThreshold.setText("lev thr", "dB");
+	K_LevelThreshold.ParamLink(audioProcessor.GetParams(), "levelthr");
+	addAndMakeVisible(K_LevelThreshold);
+	K_LevelAttack.setText("lev att", "ms");
+	K_LevelAttack.ParamLink(audioProcessor.GetParams(), "levelatt");
+	addAndMakeVisible(K_LevelAttack);
+	K_LevelRelease.setText("lev rel", "ms");
+	K_LevelRelease.ParamLink(audioProcessor.GetParams(), "levelrel");
+	addAndMakeVisible(K_LevelRelease);
+	K_ClipKnee.setText("clip knee", "dB");
+	K_ClipKnee.ParamLink(audioProcessor.GetParams(), "clipknee");
+	addAndMakeVisible(K_ClipKnee);
+	B_Sidechain.setName("ext key");
+	B_Sidechain.ParamLink(audioProcessor.GetParams(), "sidechain");
+	addAndMakeVisible(B_Sidechain);
+	B_MidSide.setName("M/S");
+	B_MidSide.ParamLink(audioProcessor.GetParams(), "midside");
+	addAndMakeVisible(B_MidSide);
+	K_MidThreshold.setText("mid thr", "dB");
+	K_MidThreshold.ParamLink(audioProcessor.GetParams(), "midthr");
+	addAndMakeVisible(K_MidThreshold);
+	K_SideThreshold.setText("side thr", "dB");
+	K_SideThreshold.ParamLink(audioProcessor.GetParams(), "sidethr");
+	addAndMakeVisible(K_SideThreshold);
 
 	addAndMakeVisible(meterUI);
-
-	startTimerHz(30);
-
+	addAndMakeVisible(historyView);
 }
 
 LModelAudioProcessorEditor::~LModelAudioProcessorEditor()
@@ -67,6 +105,30 @@ void LModelAudioProcessorEditor::paint(juce::Graphics& g)
 	int w = getBounds().getWidth(), h = getBounds().getHeight();
 
 	g.drawText("LMLimiter 260115 16:38", juce::Rectangle<float>(0, h - 16, w, 16), 1);
+
+	g.drawText(cpuText, juce::Rectangle<float>(0, h - 16, w - 4, 16), juce::Justification::centredRight);
+
+	g.drawText(loudnessText, GetLoudnessBounds().toFloat(), juce::Justification::centredLeft);
+}
+
+juce::Rectangle<int> LModelAudioProcessorEditor::GetLoudnessBounds() const
+{
+	return juce::Rectangle<int>(32, 8, getWidth() - 64, 16);
+}
+
+void LModelAudioProcessorEditor::mouseDown(const juce::MouseEvent& e)
+{
+	if (GetLoudnessBounds().contains(e.getPosition()))
+	{
+		audioProcessor.ResetLoudness();//ȶI/LRA/ֵ¿ʼ
+		return;
+	}
+#if LMLIMITER_TRACE
+	if (e.y < getHeight() - 16) return;
+	auto file = juce::File::getSpecialLocation(juce::File::userDesktopDirectory).getChildFile("LMLimiter_trace.json");
+	if (LMTrace::WriteChromeJson(file.getFullPathName().toRawUTF8()))
+		DBG("trace written to " + file.getFullPathName());
+#endif
 }
 
 void LModelAudioProcessorEditor::resized()
@@ -81,11 +143,62 @@ void LModelAudioProcessorEditor::resized()
 	K_Release.setBounds(32 + 64 * 1, 32 + 64 * 1, 64, 64);
 	K_Input.setBounds(32 + 64 * 0, 32 + 64 * 2, 64, 64);
 	K_Output.setBounds(32 + 64 * 1, 32 + 64 * 2, 64, 64);
-
-	meterUI.setBounds(convXY(192, 32, w - 32, h - 32));
+	K_Adaptive.setBounds(32 + 64 * 2, 32 + 64 * 1, 64, 64);
+	B_Smooth.setBounds(32 + 64 * 2 + 4, 32 + 64 * 0 + 4, 56, 24);
+	B_TwoStage.setBounds(32 + 64 * 2 + 4, 32 + 64 * 0 + 36, 56, 24);
+	K_LevelThreshold.setBounds(32 + 64 * 3, 32 + 64 * 0, 64, 64);
+	K_LevelAttack.setBounds(32 + 64 * 3, 32 + 64 * 1, 64, 64);
+	K_LevelRelease.setBounds(32 + 64 * 3, 32 + 64 * 2, 64, 64);
+	K_ClipKnee.setBounds(32 + 64 * 4, 32 + 64 * 0, 64, 64);
+	K_MidThreshold.setBounds(32 + 64 * 4, 32 + 64 * 1, 64, 64);
+	K_SideThreshold.setBounds(32 + 64 * 4, 32 + 64 * 2, 64, 64);
+	B_Sidechain.setBounds(32 + 64 * 5 + 4, 32 + 64 * 0 + 4, 56, 24);
+	B_MidSide.setBounds(32 + 64 * 5 + 4, 32 + 64 * 0 + 36, 56, 24);
+	C_Economy.setBounds(32 + 64 * 2, 32 + 64 * 2 + 20, 64, 24);
+
+	//ͷ̶96ңԺмĵطʷͼ
+	int meterLeft = juce::jmax(448, w - 32 - 96);
+	meterUI.setBounds(convXY(meterLeft, 32, w - 32, h - 32));
+	if (meterLeft - 16 - 448 >= 32)
+	{
+		historyView.setBounds(convXY(448, 32, meterLeft - 16, h - 32));
+		historyView.setVisible(true);
+	}
+	else
+	{
+		historyView.setVisible(false);
+	}
 }
 
-void LModelAudioProcessorEditor::timerCallback()
+void LModelAudioProcessorEditor::onVBlank()
 {
-	repaint();
+	meterUI.UpdateFrame();
+	historyView.UpdateFrame();
+
+	//ֶ̫쿴壬4Hzˢ¾͹
+	auto now = juce::Time::getMillisecondCounter();
+	if (now - lastTextTime < 250) return;
+	lastTextTime = now;
+
+	//CPUռãǰ/ֵ/p99ÿʵʱԤ
+	auto load = audioProcessor.GetCpuLoad();
+	char tmp[96];
+	snprintf(tmp, sizeof(tmp), "%s cpu %.1f/%.1f/%.1f%%", LMLimiterNamespace::cpu::IsaName(audioProcessor.limiter.GetIsa()),
+		load.current, load.peak, load.p99);
+	if (cpuText != tmp)
+	{
+		cpuText = tmp;
+		repaint(getWidth() / 2, getHeight() - 16, getWidth() / 2, 16);//ֻػҰ
+	}
+
+	//
+	auto lufs = audioProcessor.GetLoudness();
+	auto fmt = [](float v) { return v > -100.0f ? juce::String(v, 1) : juce::String("-inf"); };
+	juce::String text = "M " + fmt(lufs.momentary) + "  S " + fmt(lufs.shortTerm)
+		+ "  I " + fmt(lufs.integrated) + " LUFS  LRA " + juce::String(lufs.range, 1) + " LU";
+	if (loudnessText != text)
+	{
+		loudnessText = text;
+		repaint(GetLoudnessBounds());
+	}
 }
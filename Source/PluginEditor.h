@@ -12,10 +12,11 @@
 #include "PluginProcessor.h"
 #include "ui/LM_slider.h"
 #include "ui/LMLimiterMeterUI.h"
+#include "ui/LMHistoryView.h"
 //==============================================================================
 /**
 */
-class LModelAudioProcessorEditor : public juce::AudioProcessorEditor, juce::Timer
+class LModelAudioProcessorEditor : public juce::AudioProcessorEditor
 {
 public:
 	LModelAudioProcessorEditor(LModelAudioProcessor&);
@@ -24,7 +25,8 @@ public:
 	//==============================================================================
 	void paint(juce::Graphics&) override;
 	void resized() override;
-	void timerCallback() override;//ע⣬治ڻfft
+	void onVBlank();//ÿʾ֡һΣֻҪػ
+	void mouseDown(const juce::MouseEvent& e) override;//ȶ֣trace汾trace
 
 private:
 	// This reference is provided as a quick way for your editor to
@@ -36,8 +38,27 @@ private:
 	LMKnob K_Input;
 	LMKnob K_Output;
 	LMKnob K_Threshold;
+	LMKnob K_Adaptive;
+	LMButton B_Smooth;
+	LMCombox C_Economy;
+	LMButton B_TwoStage;
+	LMKnob K_LevelThreshold;
+	LMKnob K_LevelAttack;
+	LMKnob K_LevelRelease;
+	LMKnob K_ClipKnee;
+	LMButton B_Sidechain;
+	LMButton B_MidSide;
+	LMKnob K_MidThreshold;
+	LMKnob K_SideThreshold;
 
 	LMLimiterMeterUI meterUI;
+	LMHistoryView historyView;
+
+	juce::String cpuText;
+	juce::String loudnessText;
+	juce::uint32 lastTextTime = 0;
+	juce::Rectangle<int> GetLoudnessBounds() const;
+	juce::VBlankAttachment vblank{ this, [this] { onVBlank(); } };//༭Ψһˢ
 
 	juce::ComponentBoundsConstrainer constrainer;  // ÿ߱
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LModelAudioProcessorEditor)
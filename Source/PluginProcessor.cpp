@@ -19,11 +19,12 @@ LModelAudioProcessor::LModelAudioProcessor()
 		.withInput("Input", juce::AudioChannelSet::stereo(), true)
 #endif
 		.withOutput("Output", juce::AudioChannelSet::stereo(), true)
+		.withInput("Sidechain", juce::AudioChannelSet::stereo(), false)
 #endif
 	)
 #endif
 {
-
+	InitPresets();
 }
 
 
@@ -36,12 +37,30 @@ juce::AudioProcessorValueTreeState::ParameterLayout LModelAudioProcessor::create
 	layout.add(std::make_unique<juce::AudioParameterFloat>("input", "input", -30, 30, 0));
 	layout.add(std::make_unique<juce::AudioParameterFloat>("output", "output", -30, 30, 0));
 	layout.add(std::make_unique<juce::AudioParameterFloat>("threshold", "threshold", -30, 30, 0));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("adaptive", "adaptive release", 0, 100, 0));
+	layout.add(std::make_unique<juce::AudioParameterBool>("smooth", "smooth attack", false));
+	//ģʽlevelerֵƫƣ thresholdattackreleaseͿ켶ʱ
+	layout.add(std::make_unique<juce::AudioParameterBool>("twostage", "two stage", false));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("levelthr", "leveler threshold", -12, 0, -3));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("levelatt", "leveler attack", 1, 500, 30));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("levelrel", "leveler release", 10, 2000, 300));
+	//ʡģʽÿ 4/8/16/32 һ
+	layout.add(std::make_unique<juce::AudioParameterChoice>("economy", "economy", juce::StringArray{ "eco off", "eco 4", "eco 8", "eco 16", "eco 32" }, 0));
+	//ȫֵ¶ dB ʼ0 Ӳ
+	layout.add(std::make_unique<juce::AudioParameterFloat>("clipknee", "clip knee", 0, 6, 0));
+	//ⲿ򿪲˲ʱ
+	layout.add(std::make_unique<juce::AudioParameterBool>("sidechain", "external sidechain", false));
+	//M/S ģʽͰСϣԵֵ threshold ƫ
+	layout.add(std::make_unique<juce::AudioParameterBool>("midside", "mid/side", false));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("midthr", "mid threshold", -12, 12, 0));
+	layout.add(std::make_unique<juce::AudioParameterFloat>("sidethr", "side threshold", -12, 12, 0));
 
 	return layout;
 }
 
 LModelAudioProcessor::~LModelAudioProcessor()
 {
+	loudnessThread.stopThread(1000);
 }
 
 //==============================================================================
@@ -84,38 +103,262 @@ double LModelAudioProcessor::getTailLengthSeconds() const
 
 int LModelAudioProcessor::getNumPrograms()
 {
-	return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
+	return NumPresets;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
 	// so this should be at least 1, even if you're not really implementing programs.
 }
 
 int LModelAudioProcessor::getCurrentProgram()
 {
-	return 0;
+	return currentPreset;
 }
 
 void LModelAudioProcessor::setCurrentProgram(int index)
 {
+	RecallPreset(index);
 }
 
 const juce::String LModelAudioProcessor::getProgramName(int index)
 {
-	return "LMChorus";
+	if (index < 0 || index >= NumPresets) return {};
+	return presets[index].name;
 }
 
 void LModelAudioProcessor::changeProgramName(int index, const juce::String& newName)
 {
+	if (index < 0 || index >= NumPresets) return;
+	presets[index].name = newName;
+}
+
+//==============================================================================
+void LModelAudioProcessor::InitPresets()
+{
+	//lookahead, attack, release, input, output, threshold, adaptive, smooth, economy,
+	//twoStage, levelThreshold, levelAttack, levelRelease, clipKnee, sidechain,
+	//midSide, midThreshold, sideThreshold
+	const Preset factory[] = {
+		{ "Default",       { 5, 1, 10, 0, 0, 0, 0, 0, 0, 0, -3, 30, 300, 0, 0, 0, 0, 0 } },
+		{ "Transparent",   { 10, 10, 200, 0, 0, 0, 0, 1, 0, 0, -3, 30, 300, 0, 0, 0, 0, 0 } },
+		{ "Punchy",        { 2, 0, 30, 0, 0, 0, 0, 0, 0, 0, -3, 30, 300, 0, 0, 0, 0, 0 } },
+		{ "Loud",          { 5, 1, 60, 6, 0, 0, 50, 0, 0, 0, -3, 30, 300, 1, 0, 0, 0, 0 } },
+		{ "Ceiling -1dB",  { 5, 1, 10, 0, -1, 0, 0, 0, 0, 0, -3, 30, 300, 0, 0, 0, 0, 0 } },
+		{ "Mastering",     { 10, 1, 30, 0, 0, 0, 0, 1, 0, 1, -4, 50, 500, 0.5f, 0, 0, 0, 0 } },
+	};
+	const int numFactory = sizeof(factory) / sizeof(factory[0]);
+	for (int i = 0; i < NumPresets; ++i)
+	{
+		if (i < numFactory) presets[i] = factory[i];
+		else presets[i] = { "Preset " + juce::String(i + 1), factory[0].params };
+	}
+}
+
+LModelAudioProcessor::ParamSnapshot LModelAudioProcessor::GetCurrentParams() const
+{
+	return { lookaheadParam->load(), attackParam->load(), releaseParam->load(),
+		inputParam->load(), outputParam->load(), thresholdParam->load(), adaptiveParam->load(), smoothParam->load(), economyParam->load(),
+		twoStageParam->load(), levelThresholdParam->load(), levelAttackParam->load(), levelReleaseParam->load(),
+		clipKneeParam->load(), sidechainParam->load(),
+		midSideParam->load(), midThresholdParam->load(), sideThresholdParam->load() };
+}
+
+void LModelAudioProcessor::StorePreset(int index, const juce::String& name)
+{
+	if (index < 0 || index >= NumPresets) return;
+	presets[index] = { name, GetCurrentParams() };
+	currentPreset = index;
+}
+
+void LModelAudioProcessor::RecallPreset(int index)
+{
+	if (index < 0 || index >= NumPresets) return;
+	currentPreset = index;
+
+	//ȰƵ̣߳д֪ͨдƵ߳̿Իȥ
+	//˵Ƶ߳ûܣֱд
+	const uint32_t generation = ++presetGeneration;
+	presetRecalls.Push({ generation, presets[index].params });
 
+	const ParamSnapshot& p = presets[index].params;
+	auto set = [this](const char* id, float value)
+	{
+		auto* param = Params.getParameter(id);
+		param->setValueNotifyingHost(param->convertTo0to1(value));
+	};
+	set("lookahead", p.lookahead);
+	set("attack", p.attack);
+	set("release", p.release);
+	set("input", p.input);
+	set("output", p.output);
+	set("threshold", p.threshold);
+	set("adaptive", p.adaptive);
+	set("smooth", p.smooth);
+	set("economy", p.economy);
+	set("twostage", p.twoStage);
+	set("levelthr", p.levelThreshold);
+	set("levelatt", p.levelAttack);
+	set("levelrel", p.levelRelease);
+	set("clipknee", p.clipKnee);
+	set("sidechain", p.sidechain);
+	set("midside", p.midSide);
+	set("midthr", p.midThreshold);
+	set("sidethr", p.sideThreshold);
+
+	presetWritten.store(generation, std::memory_order_release);
+}
+
+bool LModelAudioProcessor::PollPresetRecall()
+{
+	PresetRecall recall;
+	bool received = false;
+	while (presetRecalls.Pop(&recall, 1) == 1)
+	{
+		activeRecall = recall;//ֻµһ
+		received = true;
+	}
+	if (received) recallActive = true;
+	//òֵȽϣҲ
+	if (recallActive && (int32_t)(presetWritten.load(std::memory_order_acquire) - activeRecall.generation) >= 0)
+		recallActive = false;
+	return received;
+}
+
+juce::ValueTree LModelAudioProcessor::PresetsToValueTree() const
+{
+	juce::ValueTree bank("PresetBank");
+	bank.setProperty("current", currentPreset, nullptr);
+	for (int i = 0; i < NumPresets; ++i)
+	{
+		const Preset& preset = presets[i];
+		juce::ValueTree node("Preset");
+		node.setProperty("name", preset.name, nullptr);
+		node.setProperty("lookahead", preset.params.lookahead, nullptr);
+		node.setProperty("attack", preset.params.attack, nullptr);
+		node.setProperty("release", preset.params.release, nullptr);
+		node.setProperty("input", preset.params.input, nullptr);
+		node.setProperty("output", preset.params.output, nullptr);
+		node.setProperty("threshold", preset.params.threshold, nullptr);
+		node.setProperty("adaptive", preset.params.adaptive, nullptr);
+		node.setProperty("smooth", preset.params.smooth, nullptr);
+		node.setProperty("economy", preset.params.economy, nullptr);
+		node.setProperty("twostage", preset.params.twoStage, nullptr);
+		node.setProperty("levelthr", preset.params.levelThreshold, nullptr);
+		node.setProperty("levelatt", preset.params.levelAttack, nullptr);
+		node.setProperty("levelrel", preset.params.levelRelease, nullptr);
+		node.setProperty("clipknee", preset.params.clipKnee, nullptr);
+		node.setProperty("sidechain", preset.params.sidechain, nullptr);
+		node.setProperty("midside", preset.params.midSide, nullptr);
+		node.setProperty("midthr", preset.params.midThreshold, nullptr);
+		node.setProperty("sidethr", preset.params.sideThreshold, nullptr);
+		bank.appendChild(node, nullptr);
+	}
+	return bank;
+}
+
+void LModelAudioProcessor::PresetsFromValueTree(const juce::ValueTree& bank)
+{
+	for (int i = 0; i < NumPresets && i < bank.getNumChildren(); ++i)
+	{
+		auto node = bank.getChild(i);
+		Preset& preset = presets[i];
+		preset.name = node.getProperty("name", preset.name);
+		preset.params.lookahead = node.getProperty("lookahead", preset.params.lookahead);
+		preset.params.attack = node.getProperty("attack", preset.params.attack);
+		preset.params.release = node.getProperty("release", preset.params.release);
+		preset.params.input = node.getProperty("input", preset.params.input);
+		preset.params.output = node.getProperty("output", preset.params.output);
+		preset.params.threshold = node.getProperty("threshold", preset.params.threshold);
+		preset.params.adaptive = node.getProperty("adaptive", preset.params.adaptive);
+		preset.params.smooth = node.getProperty("smooth", preset.params.smooth);
+		preset.params.economy = node.getProperty("economy", preset.params.economy);
+		preset.params.twoStage = node.getProperty("twostage", preset.params.twoStage);
+		preset.params.levelThreshold = node.getProperty("levelthr", preset.params.levelThreshold);
+		preset.params.levelAttack = node.getProperty("levelatt", preset.params.levelAttack);
+		preset.params.levelRelease = node.getProperty("levelrel", preset.params.levelRelease);
+		preset.params.clipKnee = node.getProperty("clipknee", preset.params.clipKnee);
+		preset.params.sidechain = node.getProperty("sidechain", preset.params.sidechain);
+		preset.params.midSide = node.getProperty("midside", preset.params.midSide);
+		preset.params.midThreshold = node.getProperty("midthr", preset.params.midThreshold);
+		preset.params.sideThreshold = node.getProperty("sidethr", preset.params.sideThreshold);
+	}
+	currentPreset = juce::jlimit(0, NumPresets - 1, (int)bank.getProperty("current", 0));
 }
 
 //==============================================================================
 void LModelAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
+	limiter.SetSampleRate(sampleRate);
+	limiter.Reset();
+	lastParamsValid = false;
+
+	// cpuid ѡںˣֻѡһΣ LMLIMITER_ISA ǿָ A/B Ա
+	using namespace LMLimiterNamespace::cpu;
+	limiter.SetIsa(SelectIsa());
+	juce::Logger::writeToLog(juce::String("LMLimiter: ") + IsaName(limiter.GetIsa()) + " kernels (cpu supports "
+		+ IsaName(DetectIsa()) + ")");
+
+	loudnessThread.stopThread(1000);
+	loudness.SetSampleRate(sampleRate);//˳
+	loudnessThread.startThread();
 }
 
 void LModelAudioProcessor::releaseResources()
 {
 	// When playback stops, you can use this as an opportunity to free up any
 	// spare memory, etc.
+	loudnessThread.stopThread(1000);
+#if LMLIMITER_DUMP_CPU_HISTOGRAM
+	DumpCpuHistogram();
+#endif
+}
+
+//==============================================================================
+void LModelAudioProcessor::RecordBlockTime(std::chrono::steady_clock::time_point start, int numSamples)
+{
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	uint64_t ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+	double budgetNs = numSamples * 1.0e9 / getSampleRate();
+	if (numSamples <= 0 || budgetNs <= 0) return;
+
+	double load = ns / budgetNs;//1.0 = 100%
+	blockTimeNs.Record(ns);
+	blockLoad.Record((uint64_t)(load * 10000.0));
+	currentLoad.store((float)(load * 100.0), std::memory_order_relaxed);
+}
+
+LModelAudioProcessor::CpuLoad LModelAudioProcessor::GetCpuLoad() const
+{
+	CpuLoad l;
+	l.current = currentLoad.load(std::memory_order_relaxed);
+	l.peak = blockLoad.GetMax() / 100.0f;
+	l.p99 = blockLoad.GetPercentile(0.99) / 100.0f;
+	return l;
+}
+
+void LModelAudioProcessor::ResetCpuLoad()
+{
+	blockTimeNs.Clear();
+	blockLoad.Clear();
+}
+
+void LModelAudioProcessor::DumpCpuHistogram()
+{
+	if (blockTimeNs.GetCount() == 0) return;
+
+	juce::String s;
+	s << "LMLimiter block time (" << LMLimiterNamespace::cpu::IsaName(limiter.GetIsa()) << " kernels): "
+		<< (juce::int64)blockTimeNs.GetCount() << " blocks"
+		<< ", p50 " << (juce::int64)blockTimeNs.GetPercentile(0.5) << " ns"
+		<< ", p99 " << (juce::int64)blockTimeNs.GetPercentile(0.99) << " ns"
+		<< ", p999 " << (juce::int64)blockTimeNs.GetPercentile(0.999) << " ns"
+		<< ", max " << (juce::int64)blockTimeNs.GetMax() << " ns"
+		<< ", load p99 " << juce::String(GetCpuLoad().p99, 2) << "%\n";
+	for (int i = 0; i < LMHistogram::NumBuckets; ++i)
+	{
+		uint64_t c = blockTimeNs.GetBucketCount(i);
+		if (c == 0) continue;
+		s << "  [" << (juce::int64)LMHistogram::BucketLowerBound(i) << ", "
+			<< (juce::int64)LMHistogram::BucketUpperBound(i) << "] ns: " << (juce::int64)c << "\n";
+	}
+	juce::Logger::writeToLog(s);
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -139,6 +382,10 @@ bool LModelAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) co
 		return false;
 #endif
 
+	//ߣԹصĻ
+	if (layouts.getNumChannels(true, 1) > 2)
+		return false;
+
 	return true;
 #endif
 }
@@ -147,6 +394,9 @@ bool LModelAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) co
 
 void LModelAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+	const auto blockStart = std::chrono::steady_clock::now();
+	LMTRACE_SCOPE("processBlock");
+
 	int isMidiUpdata = 0;
 	juce::MidiMessage MidiMsg;//ȴmidi¼
 	int MidiTime;
@@ -165,22 +415,79 @@ void LModelAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::
 	midiMessages.clear();
 
 	const int numSamples = buffer.getNumSamples();
+	//ߵʱ 1 Ѿǲ߸ûУҶõ 0 
+	//ͬҲͬдͬһطû
+	const int mainChannels = getChannelCountOfBus(true, 0);
+	const int rightChannel = mainChannels > 1 ? 1 : 0;
 	float* wavbufl = buffer.getWritePointer(0);
-	float* wavbufr = buffer.getWritePointer(1);
+	float* wavbufr = buffer.getWritePointer(rightChannel);
 	const float* recbufl = buffer.getReadPointer(0);
-	const float* recbufr = buffer.getReadPointer(1);
+	const float* recbufr = buffer.getReadPointer(rightChannel);
 
 	float SampleRate = getSampleRate();
 
-	float lookahead = *Params.getRawParameterValue("lookahead");
-	float attack = *Params.getRawParameterValue("attack");
-	float release = *Params.getRawParameterValue("release");
-	float inputdB = *Params.getRawParameterValue("input");
-	float outputdB = *Params.getRawParameterValue("output");
-	float thresholddB = *Params.getRawParameterValue("threshold");
+	//лԤʱÿգ
+	//ͬʱϢܸ߳̿տʼдԤ裬ٿһ۶Уµһ͸
+	PollPresetRecall();
+	ParamSnapshot p = recallActive ? activeRecall.params : GetCurrentParams();
+	if (!recallActive && PollPresetRecall())
+		p = activeRecall.params;
+	//ֱָͨ߹
+	const float* keyl = nullptr;
+	const float* keyr = nullptr;
+	const int keyChannels = getChannelCountOfBus(true, 1);
+	if (p.sidechain >= 0.5f && keyChannels > 0)
+	{
+		const int keyStart = mainChannels;//ߺ
+		keyl = buffer.getReadPointer(keyStart);
+		keyr = buffer.getReadPointer(keyStart + (keyChannels > 1 ? 1 : 0));
+	}
+
+	limiter.SetSmoothAttack(p.smooth >= 0.5f);//أֵ
+	const int economyIndex = juce::jlimit(0, 4, (int)(p.economy + 0.5f));
+	limiter.SetEconomy(economyIndex == 0 ? 1 : 2 << economyIndex);//1 / 4 / 8 / 16 / 32
+	if (!lastParamsValid)
+	{
+		lastParams = p;
+		lastParamsValid = true;
+	}
+
+	if (memcmp(&p, &lastParams, sizeof(p)) == 0)
+	{
+		//ûһδ
+		limiter.SetParams(p.lookahead, p.input, p.output, p.threshold, p.attack, p.release);
+		limiter.SetAdaptiveRelease(p.adaptive / 100.0f);
+		limiter.SetLeveler(p.twoStage >= 0.5f, p.levelThreshold, p.levelAttack, p.levelRelease);
+		limiter.SetClipKnee(p.clipKnee);
+		limiter.SetMidSide(p.midSide >= 0.5f, p.midThreshold, p.sideThreshold);
+		limiter.ProcessBlock(recbufl, recbufr, wavbufl, wavbufr, numSamples, keyl, keyr);
+	}
+	else
+	{
+		//ˣгɹ̶ȵӿ飬ÿӿϵ䣬һֵߵһֵ
+		//lookahead ֱֵֵʱԼƽػȥ
+		for (int start = 0; start < numSamples; start += AutomationSubBlockSize)
+		{
+			int n = juce::jmin(AutomationSubBlockSize, numSamples - start);
+			float t = (float)(start + n) / numSamples;
+			auto lerp = [t](float a, float b) { return a + (b - a) * t; };
+			limiter.SetParams(p.lookahead,
+				lerp(lastParams.input, p.input), lerp(lastParams.output, p.output), lerp(lastParams.threshold, p.threshold),
+				lerp(lastParams.attack, p.attack), lerp(lastParams.release, p.release));
+			limiter.SetAdaptiveRelease(lerp(lastParams.adaptive, p.adaptive) / 100.0f);
+			limiter.SetLeveler(p.twoStage >= 0.5f, lerp(lastParams.levelThreshold, p.levelThreshold),
+				lerp(lastParams.levelAttack, p.levelAttack), lerp(lastParams.levelRelease, p.levelRelease));
+			limiter.SetClipKnee(lerp(lastParams.clipKnee, p.clipKnee));
+			limiter.SetMidSide(p.midSide >= 0.5f, lerp(lastParams.midThreshold, p.midThreshold),
+				lerp(lastParams.sideThreshold, p.sideThreshold));
+			limiter.ProcessBlock(recbufl + start, recbufr + start, wavbufl + start, wavbufr + start, n,
+				keyl ? keyl + start : nullptr, keyr ? keyr + start : nullptr);
+		}
+		lastParams = p;
+	}
+	loudness.ProcessBlock(wavbufl, wavbufr, numSamples);
 
-	limiter.SetParams(lookahead, inputdB, outputdB, thresholddB, attack, release);
-	limiter.ProcessBlock(recbufl, recbufr, wavbufl, wavbufr, numSamples);
+	RecordBlockTime(blockStart, numSamples);
 }
 
 //==============================================================================
@@ -204,26 +511,52 @@ void LModelAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 	// You could do that either as raw data, or use the XML or ValueTree classes
 	// as intermediaries to make it easy to save and load complex data.
 
-	// һ XML ڵ
-	juce::XmlElement xml("LMEQ_Settings");
-
-	/*juce::MemoryBlock eqDataBlock;
-	eqDataBlock.append(&manager, sizeof(ResonatorManager));
-	juce::String base64Data = eqDataBlock.toBase64Encoding();
-	xml.setAttribute("VIB_MANAGER", base64Data);//resonance
-	*/
+	//ʽ'LMLS' + 汾(Сuint32) + ValueTree::writeToStreamԤһӽڵ
 	auto state = Params.copyState();
-	xml.setAttribute("Knob_Data", state.toXmlString());//ť
+	state.appendChild(PresetsToValueTree(), nullptr);
 
-	juce::String xmlString = xml.toString();
-	destData.append(xmlString.toRawUTF8(), xmlString.getNumBytesAsUTF8());
+	juce::MemoryOutputStream out(destData, false);
+	out.writeInt((int)StateMagic);
+	out.writeInt((int)StateVersion);
+	state.writeToStream(out);
 }
 
 void LModelAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
 	// You should use this method to restore your parameters from this memory block,
 	// whose contents will have been created by the getStateInformation() call.
-	  //  data תΪַԽ XML
+	if (sizeInBytes < 8 || juce::ByteOrder::littleEndianInt(data) != StateMagic)
+	{
+		LoadLegacyXmlState(data, sizeInBytes);//ϰ汾 <LMEQ_Settings Knob_Data="..."/>
+		return;
+	}
+
+	const char* bytes = static_cast<const char*>(data);
+	juce::uint32 version = juce::ByteOrder::littleEndianInt(bytes + 4);
+	if (version > StateVersion)
+	{
+		DBG("Error: state was saved by a newer LMLimiter (version " + juce::String(version) + ")");
+		return;
+	}
+
+	auto state = juce::ValueTree::readFromData(bytes + 8, (size_t)sizeInBytes - 8);
+	if (!state.hasType(Params.state.getType()))
+	{
+		DBG("Error: Unable to load binary settings");
+		return;
+	}
+	auto bank = state.getChildWithName("PresetBank");
+	if (bank.isValid())
+	{
+		PresetsFromValueTree(bank);
+		state.removeChild(bank, nullptr);
+	}
+	Params.replaceState(state);
+}
+
+bool LModelAudioProcessor::LoadLegacyXmlState(const void* data, int sizeInBytes)
+{
+	//  data תΪַԽ XML
 	juce::String xmlString(static_cast<const char*>(data), sizeInBytes);
 
 	//  XML
@@ -231,7 +564,7 @@ void LModelAudioProcessor::setStateInformation(const void* data, int sizeInBytes
 	if (xml == nullptr || !xml->hasTagName("LMEQ_Settings"))
 	{
 		DBG("Error: Unable to load XML settings");
-		return;
+		return false;
 	}
 
 	/*
@@ -245,6 +578,7 @@ void LModelAudioProcessor::setStateInformation(const void* data, int sizeInBytes
 	*/
 	auto KnobDataXML = xml->getStringAttribute("Knob_Data");
 	Params.replaceState(juce::ValueTree::fromXml(KnobDataXML));
+	return true;
 }
 
 
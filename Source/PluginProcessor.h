@@ -10,6 +10,14 @@
 
 #include <JuceHeader.h>
 #include "dsp/lmlimiter.h"
+#include "dsp/lmhistogram.h"
+#include "dsp/lmloudness.h"
+#include "dsp/lmspsc.h"
+
+//1: releaseResources ʱÿʱֱͼд־
+#ifndef LMLIMITER_DUMP_CPU_HISTOGRAM
+#define LMLIMITER_DUMP_CPU_HISTOGRAM 0
+#endif
 
 //==============================================================================
 /**
@@ -64,11 +72,122 @@ public:
 	
 	LMLimiter limiter;
 
+	//CPUռãÿĴʱռʵʱʱİٷֱ
+	struct CpuLoad
+	{
+		float current = 0, peak = 0, p99 = 0;
+	};
+	CpuLoad GetCpuLoad() const;
+	void ResetCpuLoad();
+
+	//˵ BS.1770 ȣM/S/I/LRA
+	LMLoudnessMeter::Values GetLoudness() const
+	{
+		return loudness.GetValues();
+	}
+	void ResetLoudness()
+	{
+		loudness.RequestReset();
+	}
+
+	//ڴԤ⣺лʱXMLƵ߳黻
+	struct ParamSnapshot
+	{
+		float lookahead, attack, release, input, output, threshold, adaptive, smooth, economy;
+		float twoStage, levelThreshold, levelAttack, levelRelease;//ģʽ
+		float clipKnee;//ȫ knee
+		float sidechain;//ⲿ
+		float midSide, midThreshold, sideThreshold;//M/S ģʽСֵƫ
+	};
+	static constexpr int NumPresets = 8;
+	void StorePreset(int index, const juce::String& name);//ѵǰԤ裨Ϣ̣߳
+	void RecallPreset(int index);//Ϣ߳
+
 private:
 	//Synth Param
 	static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 	juce::AudioProcessorValueTreeState Params{ *this, nullptr, "Parameters", createParameterLayout() };
 
+	//processBlock ֻЩʱõָ룬Ƶ߳ﲻַ
+	std::atomic<float>* lookaheadParam = Params.getRawParameterValue("lookahead");
+	std::atomic<float>* attackParam = Params.getRawParameterValue("attack");
+	std::atomic<float>* releaseParam = Params.getRawParameterValue("release");
+	std::atomic<float>* inputParam = Params.getRawParameterValue("input");
+	std::atomic<float>* outputParam = Params.getRawParameterValue("output");
+	std::atomic<float>* thresholdParam = Params.getRawParameterValue("threshold");
+	std::atomic<float>* adaptiveParam = Params.getRawParameterValue("adaptive");
+	std::atomic<float>* smoothParam = Params.getRawParameterValue("smooth");
+	std::atomic<float>* economyParam = Params.getRawParameterValue("economy");
+	std::atomic<float>* twoStageParam = Params.getRawParameterValue("twostage");
+	std::atomic<float>* levelThresholdParam = Params.getRawParameterValue("levelthr");
+	std::atomic<float>* levelAttackParam = Params.getRawParameterValue("levelatt");
+	std::atomic<float>* levelReleaseParam = Params.getRawParameterValue("levelrel");
+	std::atomic<float>* clipKneeParam = Params.getRawParameterValue("clipknee");
+	std::atomic<float>* sidechainParam = Params.getRawParameterValue("sidechain");
+	std::atomic<float>* midSideParam = Params.getRawParameterValue("midside");
+	std::atomic<float>* midThresholdParam = Params.getRawParameterValue("midthr");
+	std::atomic<float>* sideThresholdParam = Params.getRawParameterValue("sidethr");
+
+	LMHistogram blockTimeNs;//ÿʱ
+	LMHistogram blockLoad;//ÿʱ/ʵʱԤ㣬λ0.01%
+	std::atomic<float> currentLoad{ 0 };
+	void RecordBlockTime(std::chrono::steady_clock::time_point start, int numSamples);
+	void DumpCpuHistogram();
+
+	//Ƶֻ߳KȨ100msۼӣſ/ֱͼں̨߳
+	LMLoudnessMeter loudness;
+	class LoudnessThread : public juce::Thread
+	{
+	private:
+		LMLoudnessMeter& meter;
+	public:
+		LoudnessThread(LMLoudnessMeter& meter) : juce::Thread("LMLimiter loudness"), meter(meter) {}
+		void run() override
+		{
+			while (!threadShouldExit())
+			{
+				meter.Update();
+				wait(50);
+			}
+		}
+	};
+	LoudnessThread loudnessThread{ loudness };
+
+	//״̬洢ͷ + ValueTree ƣϰ汾 XML Ҳܶ
+	static constexpr juce::uint32 StateMagic = 0x534c4d4c;//"LMLS"
+	static constexpr juce::uint32 StateVersion = 1;
+	bool LoadLegacyXmlState(const void* data, int sizeInBytes);
+
+	struct Preset
+	{
+		juce::String name;
+		ParamSnapshot params;
+	};
+	Preset presets[NumPresets];
+	int currentPreset = 0;
+	//лԤ裺Ϣ߳ȰƸƵ̣߳дд presetWritten εţ
+	//Ƶ߳õԼһݿһֱõдΪֹм䲻һһɵĲ
+	struct PresetRecall
+	{
+		uint32_t generation = 0;
+		ParamSnapshot params{};
+	};
+	LMSpscRing<PresetRecall, 8> presetRecalls;
+	uint32_t presetGeneration = 0;//Ϣ߳
+	std::atomic<uint32_t> presetWritten{ 0 };
+	PresetRecall activeRecall;//Ƶ߳
+	bool recallActive = false;//Ƶ߳
+	bool PollPresetRecall();
+	ParamSnapshot GetCurrentParams() const;
+
+	//ԶJUCE Ĳ仯ʱ㴫 processBlockֻڿ߽£
+	//֮˾Ͱ̶ȵӿֵȥ
+	static constexpr int AutomationSubBlockSize = 64;
+	ParamSnapshot lastParams;
+	bool lastParamsValid = false;
+	void InitPresets();
+	juce::ValueTree PresetsToValueTree() const;
+	void PresetsFromValueTree(const juce::ValueTree& tree);
 
 	//==============================================================================
 	JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LModelAudioProcessor)
@@ -0,0 +1,172 @@
+#include "lmlimiter_c.h"
+#include "../dsp/lmlimiter.h"
+
+#include <new>
+#include <stdint.h>
+#include <string.h>
+
+namespace
+{
+	constexpr int ScratchFrames = 256;
+	constexpr int NumParams = 6;
+
+	struct alignas(64) Instance
+	{
+		LMLimiter limiter;
+		float params[NumParams] = { 5.0f, 1.0f, 10.0f, 0.0f, 0.0f, 0.0f };//ͲĬֵһ
+		float scratchL[ScratchFrames];
+		float scratchR[ScratchFrames];
+
+		void ApplyParams()
+		{
+			limiter.SetParams(params[LMLIMITER_PARAM_LOOKAHEAD_MS],
+				params[LMLIMITER_PARAM_INPUT_DB],
+				params[LMLIMITER_PARAM_OUTPUT_DB],
+				params[LMLIMITER_PARAM_THRESHOLD_DB],
+				params[LMLIMITER_PARAM_ATTACK_MS],
+				params[LMLIMITER_PARAM_RELEASE_MS]);
+		}
+	};
+
+	Instance* Cast(lmlimiter* lim) { return reinterpret_cast<Instance*>(lim); }
+	const Instance* Cast(const lmlimiter* lim) { return reinterpret_cast<const Instance*>(lim); }
+}
+
+extern "C" {
+
+int lmlimiter_api_version(void)
+{
+	return LMLIMITER_API_VERSION;
+}
+
+size_t lmlimiter_instance_size(void)
+{
+	return sizeof(Instance);
+}
+
+size_t lmlimiter_instance_alignment(void)
+{
+	return alignof(Instance);
+}
+
+lmlimiter* lmlimiter_create(void* mem, size_t memSize)
+{
+	if (mem == nullptr || memSize < sizeof(Instance)) return nullptr;
+	if (reinterpret_cast<uintptr_t>(mem) % alignof(Instance) != 0) return nullptr;
+
+	Instance* inst = new (mem) Instance();
+	inst->ApplyParams();
+	return reinterpret_cast<lmlimiter*>(inst);
+}
+
+void lmlimiter_destroy(lmlimiter* lim)
+{
+	if (lim) Cast(lim)->~Instance();
+}
+
+int lmlimiter_prepare(lmlimiter* lim, double sampleRate)
+{
+	if (sampleRate < 8000.0 || sampleRate > 192000.0) return -1;
+	Instance* inst = Cast(lim);
+	inst->limiter.SetSampleRate((float)sampleRate);
+	inst->ApplyParams();
+	inst->limiter.Reset();
+	return 0;
+}
+
+void lmlimiter_reset(lmlimiter* lim)
+{
+	Cast(lim)->limiter.Reset();
+}
+
+void lmlimiter_set_param(lmlimiter* lim, lmlimiter_param param, float value)
+{
+	if ((unsigned)param >= (unsigned)NumParams) return;
+	Instance* inst = Cast(lim);
+	if (inst->params[param] == value) return;
+	inst->params[param] = value;
+	inst->ApplyParams();
+}
+
+float lmlimiter_get_param(const lmlimiter* lim, lmlimiter_param param)
+{
+	if ((unsigned)param >= (unsigned)NumParams) return 0.0f;
+	return Cast(lim)->params[param];
+}
+
+int lmlimiter_process_planar(lmlimiter* lim, const float* const* in, float* const* out,
+	int numChannels, int numFrames)
+{
+	if (numChannels < 1 || numFrames < 0) return -1;
+	Instance* inst = Cast(lim);
+	//3ԭͨ
+	for (int c = 2; c < numChannels; ++c)
+	{
+		if (out[c] != in[c]) memmove(out[c], in[c], sizeof(float) * numFrames);
+	}
+	if (numChannels >= 2)
+	{
+		inst->limiter.ProcessBlock(in[0], in[1], out[0], out[1], numFrames);
+		return 0;
+	}
+
+	//ιͬһ·scratch
+	for (int done = 0; done < numFrames; done += ScratchFrames)
+	{
+		int n = numFrames - done < ScratchFrames ? numFrames - done : ScratchFrames;
+		inst->limiter.ProcessBlock(in[0] + done, in[0] + done, out[0] + done, inst->scratchR, n);
+	}
+	return 0;
+}
+
+int lmlimiter_process_interleaved(lmlimiter* lim, const float* in, float* out,
+	int numChannels, int numFrames)
+{
+	if (numChannels < 1 || numFrames < 0) return -1;
+	Instance* inst = Cast(lim);
+	float* l = inst->scratchL;
+	float* r = inst->scratchR;
+	const int stride = numChannels;
+	const int right = numChannels >= 2 ? 1 : 0;//ʱҲǵ0
+
+	for (int done = 0; done < numFrames; done += ScratchFrames)
+	{
+		int n = numFrames - done < ScratchFrames ? numFrames - done : ScratchFrames;
+		const float* src = in + (size_t)done * stride;
+		float* dst = out + (size_t)done * stride;
+		for (int i = 0; i < n; ++i)
+		{
+			l[i] = src[i * stride];
+			r[i] = src[i * stride + right];
+		}
+		inst->limiter.ProcessBlock(l, r, l, r, n);//ProcessBlockԭش
+		for (int i = 0; i < n; ++i)
+		{
+			dst[i * stride] = l[i];
+			if (right) dst[i * stride + 1] = r[i];
+			//3ԭͨԭشʱ
+			if (dst != src)
+			{
+				for (int c = 2; c < numChannels; ++c) dst[i * stride + c] = src[i * stride + c];
+			}
+		}
+	}
+	return 0;
+}
+
+int lmlimiter_get_latency_samples(const lmlimiter* lim)
+{
+	return Cast(lim)->limiter.GetLatencySamples();
+}
+
+void lmlimiter_get_meters(lmlimiter* lim, lmlimiter_meters* meters)
+{
+#if WithEditor
+	Cast(lim)->limiter.GetMeterValues(meters->inputdB, meters->outputdB, meters->thresholddB, meters->reductiondB);
+#else
+	meters->inputdB = meters->outputdB = -1000.0f;
+	meters->thresholddB = meters->reductiondB = 0.0f;
+#endif
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+/*
+lmlimiter C API
+
+Plain C wrapper around LMLimiter for hosts that don't use JUCE (or C++).
+The library never allocates: the host queries lmlimiter_instance_size() /
+lmlimiter_instance_alignment(), hands over a block of memory, and owns it.
+Instances share no state, so any number of them can live in one process;
+a single instance must not be used from two threads at the same time.
+*/
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32)
+#if defined(LMLIMITER_C_BUILD)
+#define LMLIMITER_API __declspec(dllexport)
+#else
+#define LMLIMITER_API __declspec(dllimport)
+#endif
+#else
+#define LMLIMITER_API __attribute__((visibility("default")))
+#endif
+
+#define LMLIMITER_API_VERSION 1
+
+typedef struct lmlimiter lmlimiter;
+
+typedef enum lmlimiter_param
+{
+	LMLIMITER_PARAM_LOOKAHEAD_MS = 0,	/* 0 .. 20 */
+	LMLIMITER_PARAM_ATTACK_MS = 1,		/* 0 .. 500 */
+	LMLIMITER_PARAM_RELEASE_MS = 2,		/* 4 .. 500 */
+	LMLIMITER_PARAM_INPUT_DB = 3,		/* -30 .. 30 */
+	LMLIMITER_PARAM_OUTPUT_DB = 4,		/* -30 .. 30 */
+	LMLIMITER_PARAM_THRESHOLD_DB = 5	/* -30 .. 30 */
+} lmlimiter_param;
+
+typedef struct lmlimiter_meters
+{
+	float inputdB;
+	float outputdB;
+	float thresholddB;
+	float reductiondB;
+} lmlimiter_meters;
+
+/* API version the library was built with, compare against LMLIMITER_API_VERSION */
+LMLIMITER_API int lmlimiter_api_version(void);
+
+/* memory the host must provide for one instance */
+LMLIMITER_API size_t lmlimiter_instance_size(void);
+LMLIMITER_API size_t lmlimiter_instance_alignment(void);
+
+/* constructs an instance in mem, returns NULL if mem is too small or misaligned */
+LMLIMITER_API lmlimiter* lmlimiter_create(void* mem, size_t memSize);
+/* destroys the instance, the memory stays owned by the host */
+LMLIMITER_API void lmlimiter_destroy(lmlimiter* lim);
+
+/* returns 0 on success, -1 for an unsupported sample rate */
+LMLIMITER_API int lmlimiter_prepare(lmlimiter* lim, double sampleRate);
+LMLIMITER_API void lmlimiter_reset(lmlimiter* lim);
+
+/* takes effect immediately, the limiter is updated inside this call */
+LMLIMITER_API void lmlimiter_set_param(lmlimiter* lim, lmlimiter_param param, float value);
+LMLIMITER_API float lmlimiter_get_param(const lmlimiter* lim, lmlimiter_param param);
+
+/* limits channels 0 and 1 (a single channel is limited as mono), channels from 2 on are
+   copied through unchanged; interleaved frames are numChannels floats apart.
+   in and out may alias. returns 0 on success, -1 if numChannels < 1 or numFrames < 0 */
+LMLIMITER_API int lmlimiter_process_planar(lmlimiter* lim, const float* const* in, float* const* out,
+	int numChannels, int numFrames);
+LMLIMITER_API int lmlimiter_process_interleaved(lmlimiter* lim, const float* in, float* out,
+	int numChannels, int numFrames);
+
+/* latency for the current lookahead, updated as soon as set_param returns */
+LMLIMITER_API int lmlimiter_get_latency_samples(const lmlimiter* lim);
+LMLIMITER_API void lmlimiter_get_meters(lmlimiter* lim, lmlimiter_meters* meters);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+/*
+lmcpu: ʱ CPU ֧һָ lmkernels.h ķ
+AVX2/AVX-512  cpuid λҪϵͳûд򿪶ӦļĴ״̬XCR0ȻǷָ
+ LMLIMITER_ISA=scalar/sse2/avx2/avx512 ǿָA/B Աãᳬ CPU ʵֵ֧
+*/
+
+namespace LMLimiterNamespace
+{
+	namespace cpu
+	{
+		enum class Isa { Scalar = 0, SSE2, AVX2, AVX512 };
+
+		inline const char* IsaName(Isa isa)
+		{
+			switch (isa)
+			{
+			case Isa::SSE2: return "SSE2";
+			case Isa::AVX2: return "AVX2";
+			case Isa::AVX512: return "AVX-512";
+			default: return "scalar";
+			}
+		}
+
+		//ִСд"avx-512"  "avx512" 
+		inline bool ParseIsa(const char* name, Isa& isa)
+		{
+			if (!name) return false;
+			char s[16] = { 0 };
+			int n = 0;
+			for (const char* p = name; *p && n < 15; ++p)
+				if (*p != '-' && *p != '_') s[n++] = (char)tolower((unsigned char)*p);
+			if (strcmp(s, "scalar") == 0) isa = Isa::Scalar;
+			else if (strcmp(s, "sse2") == 0) isa = Isa::SSE2;
+			else if (strcmp(s, "avx2") == 0) isa = Isa::AVX2;
+			else if (strcmp(s, "avx512") == 0) isa = Isa::AVX512;
+			else return false;
+			return true;
+		}
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		inline void Cpuid(int leaf, int sub, unsigned int r[4])
+		{
+			int a[4];
+			__cpuidex(a, leaf, sub);
+			for (int i = 0; i < 4; ++i) r[i] = (unsigned int)a[i];
+		}
+		inline unsigned long long Xgetbv() { return _xgetbv(0); }
+#define LMCPU_X86 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		inline void Cpuid(int leaf, int sub, unsigned int r[4])
+		{
+			__cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+		}
+		inline unsigned long long Xgetbv()
+		{
+			unsigned int lo, hi;
+			__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+			return ((unsigned long long)hi << 32) | lo;
+		}
+#define LMCPU_X86 1
+#endif
+
+		//CPU Ͳϵͳֵ֧һֻڵһεʱ
+		inline Isa DetectIsa()
+		{
+			static const Isa detected = []
+			{
+#if LMCPU_X86
+				unsigned int r[4];
+				Cpuid(0, 0, r);
+				const unsigned int maxLeaf = r[0];
+				Cpuid(1, 0, r);
+				if (!(r[3] & (1u << 26))) return Isa::Scalar;//SSE2
+				const bool osxsave = (r[2] & (1u << 27)) != 0, avx = (r[2] & (1u << 28)) != 0;
+				if (!osxsave || !avx || maxLeaf < 7) return Isa::SSE2;
+				const unsigned long long xcr0 = Xgetbv();
+				Cpuid(7, 0, r);
+				if ((xcr0 & 0x6) != 0x6 || !(r[1] & (1u << 5))) return Isa::SSE2;//XMM/YMM ״̬AVX2
+				if ((xcr0 & 0xe6) != 0xe6 || !(r[1] & (1u << 16))) return Isa::AVX2;//ټ opmask/ZMM ״̬AVX-512F
+				return Isa::AVX512;
+#else
+				return Isa::Scalar;
+#endif
+			}();
+			return detected;
+		}
+
+		//override Ϊʱ LMLIMITER_ISAϲ CPU ֧־ DetectIsa()
+		inline Isa SelectIsa(const char* override = nullptr)
+		{
+			const Isa best = DetectIsa();
+			if (!override) override = getenv("LMLIMITER_ISA");
+			Isa isa;
+			if (!ParseIsa(override, isa) || isa > best) return best;
+			return isa;
+		}
+	}
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include "lmsimd.h"
+
+/*
+lmfastmath: ͵ƽõĿ log2 / exp2 / dB<->
+ǲָ + βʽϵǰϵģûз֧
+simd::scalar / sse2 / avx2 / avx512 һ Vec 汾 lmsimd.h һʱã㷨ͱ汾ȫһ
+
+ȫ float ɨһ顢 double  log2/exp2/pow ȳֵ float 룩
+	FastLog2(x)   x Ϊ <= 4.2e-6|log2(x)| ӽ 127 ʱռͷ1  <= 5e-7
+	FastExp2(x)   x  [-126, 126] <= 2e-7x = 0 ʱ÷ 1
+	GainToDb(x)    <= 6.5e-5 dB
+	DbToGain(x)   x  [-758, 758] dB <= 3.1e-6Լ 2.7e-5 dB0dB ÷ 1
+ƽʾ 1dB 0.01dBҲ
+ָ Vec 汾ͱ汾 lane ȫͬAVX-512 ĳ˼ lmsimd.h  _round 㣬ᱻϳ FMA
+
+߽磺
+	FastLog2 ȡ |x|0 ͷ -127 ңGainToDb Լ -764dB -inf/NaN
+	FastExp2 / DbToGain 볬ΧʱеΧϣNaN  -126DbToGain Լ -758dB
+	Щ޺ͱ߽ Source/tests/lmfastmath.cpplmlimiter_fastmath
+*/
+
+namespace LMLimiterNamespace
+{
+	namespace fastmath
+	{
+		//log2(1+t)t  [sqrt(0.5)-1, sqrt(2)-1]
+		constexpr float L1 = 1.442699726e+00f, L2 = -7.213758714e-01f, L3 = 4.804650319e-01f,
+			L4 = -3.589618547e-01f, L5 = 2.972626160e-01f, L6 = -2.726978907e-01f, L7 = 1.706343511e-01f;
+		//exp2(f)f  [-0.5, 0.5]
+		constexpr float E1 = 6.931469776e-01f, E2 = 2.402224208e-01f, E3 = 5.550733744e-02f,
+			E4 = 9.671512661e-03f, E5 = 1.326472690e-03f;
+		constexpr float Log2Of10Over20 = 0.166096404744368f;//dB -> log2
+		constexpr float TwentyLog10Of2 = 6.020599913279624f;//log2 -> dB
+		constexpr int32_t SqrtHalfBits = 0x3f3504f3;//sqrt(0.5f) λģʽ
+	}
+
+	inline float FastLog2(float x)
+	{
+		using namespace fastmath;
+		int32_t bits;
+		memcpy(&bits, &x, 4);
+		bits &= 0x7fffffff;
+		// sqrt(0.5) ȡָβ [sqrt(0.5), sqrt(2)) ÷֧
+		int32_t e = (bits - SqrtHalfBits) >> 23;
+		bits -= e * (1 << 23);
+		float m;
+		memcpy(&m, &bits, 4);
+		float t = m - 1.0f;
+		float p = L7;
+		p = p * t + L6;
+		p = p * t + L5;
+		p = p * t + L4;
+		p = p * t + L3;
+		p = p * t + L2;
+		p = p * t + L1;
+		return (float)e + p * t;
+	}
+	inline float FastExp2(float x)
+	{
+		using namespace fastmath;
+		//д !(x >= -126)NaN Ҳе -126 NaN ȥת
+		if (!(x >= -126.0f)) x = -126.0f;
+		if (x > 126.0f) x = 126.0f;
+		//x + 126.5 һضϾȡn = round(x)
+		int32_t n = (int32_t)(x + 126.5f) - 126;
+		float f = x - (float)n;
+		float p = E5;
+		p = p * f + E4;
+		p = p * f + E3;
+		p = p * f + E2;
+		p = p * f + E1;
+		p = p * f;
+		int32_t bits = (n + 127) << 23;
+		float scale;
+		memcpy(&scale, &bits, 4);
+		return (p + 1.0f) * scale;
+	}
+	inline float DbToGain(float dB)
+	{
+		return FastExp2(dB * fastmath::Log2Of10Over20);
+	}
+	inline float GainToDb(float gain)
+	{
+		return FastLog2(gain) * fastmath::TwentyLog10Of2;
+	}
+
+	namespace simd
+	{
+		//ÿռ DbToGain / GainToDb һֻ Vec  target Բͬ
+#define LMFASTMATH_DB_FUNCS(FN) \
+		FN inline Vec DbToGain(Vec dB) { return FastExp2(dB * Vec::Set(fastmath::Log2Of10Over20)); } \
+		FN inline Vec GainToDb(Vec gain) { return FastLog2(gain) * Vec::Set(fastmath::TwentyLog10Of2); }
+
+		namespace scalar
+		{
+			inline Vec FastLog2(Vec x) { return { LMLimiterNamespace::FastLog2(x.v) }; }
+			inline Vec FastExp2(Vec x) { return { LMLimiterNamespace::FastExp2(x.v) }; }
+			LMFASTMATH_DB_FUNCS()
+		}
+
+#if LMSIMD_X86
+		namespace sse2
+		{
+			LMSIMD_SSE2_FN inline Vec FastLog2(Vec x)
+			{
+				using namespace fastmath;
+				__m128i bits = _mm_and_si128(_mm_castps_si128(x.v), _mm_set1_epi32(0x7fffffff));
+				__m128i e = _mm_srai_epi32(_mm_sub_epi32(bits, _mm_set1_epi32(SqrtHalfBits)), 23);
+				bits = _mm_sub_epi32(bits, _mm_slli_epi32(e, 23));
+				Vec t = Vec{ _mm_castsi128_ps(bits) } - Vec::Set(1.0f);
+				Vec p = Vec::Set(L7);
+				p = p * t + Vec::Set(L6);
+				p = p * t + Vec::Set(L5);
+				p = p * t + Vec::Set(L4);
+				p = p * t + Vec::Set(L3);
+				p = p * t + Vec::Set(L2);
+				p = p * t + Vec::Set(L1);
+				return Vec{ _mm_cvtepi32_ps(e) } + p * t;
+			}
+			LMSIMD_SSE2_FN inline Vec FastExp2(Vec x)
+			{
+				using namespace fastmath;
+				//max/min  NaN ʱصڶNaN lane  -126ͱ汾һ
+				x = Min(Max(x, Vec::Set(-126.0f)), Vec::Set(126.0f));
+				__m128i n = _mm_sub_epi32(_mm_cvttps_epi32((x + Vec::Set(126.5f)).v), _mm_set1_epi32(126));
+				Vec f = x - Vec{ _mm_cvtepi32_ps(n) };
+				Vec p = Vec::Set(E5);
+				p = p * f + Vec::Set(E4);
+				p = p * f + Vec::Set(E3);
+				p = p * f + Vec::Set(E2);
+				p = p * f + Vec::Set(E1);
+				p = p * f;
+				Vec scale{ _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23)) };
+				return (p + Vec::Set(1.0f)) * scale;
+			}
+			LMFASTMATH_DB_FUNCS(LMSIMD_SSE2_FN)
+		}
+
+		namespace avx2
+		{
+			LMSIMD_AVX2_FN inline Vec FastLog2(Vec x)
+			{
+				using namespace fastmath;
+				__m256i bits = _mm256_and_si256(_mm256_castps_si256(x.v), _mm256_set1_epi32(0x7fffffff));
+				__m256i e = _mm256_srai_epi32(_mm256_sub_epi32(bits, _mm256_set1_epi32(SqrtHalfBits)), 23);
+				bits = _mm256_sub_epi32(bits, _mm256_slli_epi32(e, 23));
+				Vec t = Vec{ _mm256_castsi256_ps(bits) } - Vec::Set(1.0f);
+				Vec p = Vec::Set(L7);
+				p = p * t + Vec::Set(L6);
+				p = p * t + Vec::Set(L5);
+				p = p * t + Vec::Set(L4);
+				p = p * t + Vec::Set(L3);
+				p = p * t + Vec::Set(L2);
+				p = p * t + Vec::Set(L1);
+				return Vec{ _mm256_cvtepi32_ps(e) } + p * t;
+			}
+			LMSIMD_AVX2_FN inline Vec FastExp2(Vec x)
+			{
+				using namespace fastmath;
+				x = Min(Max(x, Vec::Set(-126.0f)), Vec::Set(126.0f));
+				__m256i n = _mm256_sub_epi32(_mm256_cvttps_epi32((x + Vec::Set(126.5f)).v), _mm256_set1_epi32(126));
+				Vec f = x - Vec{ _mm256_cvtepi32_ps(n) };
+				Vec p = Vec::Set(E5);
+				p = p * f + Vec::Set(E4);
+				p = p * f + Vec::Set(E3);
+				p = p * f + Vec::Set(E2);
+				p = p * f + Vec::Set(E1);
+				p = p * f;
+				Vec scale{ _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23)) };
+				return (p + Vec::Set(1.0f)) * scale;
+			}
+			LMFASTMATH_DB_FUNCS(LMSIMD_AVX2_FN)
+		}
+
+		namespace avx512
+		{
+			//λ/תĲ汾 undefined ԴGCC -Wall ± '__Y' may be used uninitializedȫ 1  maskz 汾
+			constexpr __mmask16 AllLanes = 0xFFFF;
+			LMSIMD_AVX512_FN inline Vec FastLog2(Vec x)
+			{
+				using namespace fastmath;
+				__m512i bits = _mm512_and_si512(_mm512_castps_si512(x.v), _mm512_set1_epi32(0x7fffffff));
+				__m512i e = _mm512_maskz_srai_epi32(AllLanes, _mm512_sub_epi32(bits, _mm512_set1_epi32(SqrtHalfBits)), 23);
+				bits = _mm512_sub_epi32(bits, _mm512_maskz_slli_epi32(AllLanes, e, 23));
+				Vec t = Vec{ _mm512_castsi512_ps(bits) } - Vec::Set(1.0f);
+				Vec p = Vec::Set(L7);
+				p = p * t + Vec::Set(L6);
+				p = p * t + Vec::Set(L5);
+				p = p * t + Vec::Set(L4);
+				p = p * t + Vec::Set(L3);
+				p = p * t + Vec::Set(L2);
+				p = p * t + Vec::Set(L1);
+				return Vec{ _mm512_maskz_cvtepi32_ps(AllLanes, e) } + p * t;
+			}
+			LMSIMD_AVX512_FN inline Vec FastExp2(Vec x)
+			{
+				using namespace fastmath;
+				x = Min(Max(x, Vec::Set(-126.0f)), Vec::Set(126.0f));
+				__m512i n = _mm512_sub_epi32(_mm512_maskz_cvttps_epi32(AllLanes, (x + Vec::Set(126.5f)).v), _mm512_set1_epi32(126));
+				Vec f = x - Vec{ _mm512_maskz_cvtepi32_ps(AllLanes, n) };
+				Vec p = Vec::Set(E5);
+				p = p * f + Vec::Set(E4);
+				p = p * f + Vec::Set(E3);
+				p = p * f + Vec::Set(E2);
+				p = p * f + Vec::Set(E1);
+				p = p * f;
+				Vec scale{ _mm512_castsi512_ps(_mm512_maskz_slli_epi32(AllLanes, _mm512_add_epi32(n, _mm512_set1_epi32(127)), 23)) };
+				return (p + Vec::Set(1.0f)) * scale;
+			}
+			LMFASTMATH_DB_FUNCS(LMSIMD_AVX512_FN)
+		}
+#endif
+#undef LMFASTMATH_DB_FUNCS
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+/*
+LMHistogram: Ͱֱͼ¼ʱ֮
+ÿ2ٷֳ SubBuckets ݣ < 1/SubBuckets
+Record() ֻһ relaxed ԭӼӣƵ߳/߳ã
+ȡˣUI־ͳ̣߳ʱðٷλݿԾɵģ˺
+*/
+
+class LMHistogram
+{
+public:
+	static constexpr int SubBucketBits = 3;
+	static constexpr int SubBuckets = 1 << SubBucketBits;
+	static constexpr int NumBuckets = (64 - SubBucketBits + 1) * SubBuckets;
+
+private:
+	std::atomic<uint64_t> counts[NumBuckets];
+	std::atomic<uint64_t> total{ 0 };
+	std::atomic<uint64_t> maxValue{ 0 };
+
+	static int HighestBit(uint64_t v)
+	{
+		int n = 0;
+		while (v >>= 1) ++n;
+		return n;
+	}
+
+public:
+	LMHistogram()
+	{
+		Clear();
+	}
+
+	static int BucketIndex(uint64_t v)
+	{
+		if (v < SubBuckets) return (int)v;
+		int msb = HighestBit(v);
+		int shift = msb - SubBucketBits;
+		return (shift + 1) * SubBuckets + (int)((v >> shift) & (SubBuckets - 1));
+	}
+	//Ͱ½磬BucketLowerBound(BucketIndex(v)) <= v
+	static uint64_t BucketLowerBound(int index)
+	{
+		if (index < SubBuckets) return (uint64_t)index;
+		int shift = index / SubBuckets - 1;
+		return (uint64_t)(SubBuckets + index % SubBuckets) << shift;
+	}
+	static uint64_t BucketUpperBound(int index)
+	{
+		if (index < SubBuckets) return (uint64_t)index;
+		int shift = index / SubBuckets - 1;
+		return BucketLowerBound(index) + ((uint64_t)1 << shift) - 1;
+	}
+
+	void Record(uint64_t value)
+	{
+		counts[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+		total.fetch_add(1, std::memory_order_relaxed);
+		uint64_t m = maxValue.load(std::memory_order_relaxed);
+		while (value > m && !maxValue.compare_exchange_weak(m, value, std::memory_order_relaxed)) {}
+	}
+
+	void Clear()
+	{
+		for (auto& c : counts) c.store(0, std::memory_order_relaxed);
+		total.store(0, std::memory_order_relaxed);
+		maxValue.store(0, std::memory_order_relaxed);
+	}
+
+	uint64_t GetCount() const { return total.load(std::memory_order_relaxed); }
+	uint64_t GetMax() const { return maxValue.load(std::memory_order_relaxed); }
+	uint64_t GetBucketCount(int index) const { return counts[index].load(std::memory_order_relaxed); }
+
+	//p: 0..1ظðٷλͰϽ磨ƫأ
+	uint64_t GetPercentile(double p) const
+	{
+		uint64_t n = GetCount();
+		if (n == 0) return 0;
+		uint64_t target = (uint64_t)(p * (double)n);
+		if (target >= n) target = n - 1;
+		uint64_t acc = 0;
+		for (int i = 0; i < NumBuckets; ++i)
+		{
+			acc += GetBucketCount(i);
+			if (acc > target)
+			{
+				uint64_t ub = BucketUpperBound(i);
+				uint64_t m = GetMax();
+				return ub < m ? ub : m;
+			}
+		}
+		return GetMax();
+	}
+
+	//һֱͼļӽ̸߳Ǹģͳʱٺϲ
+	void Merge(const LMHistogram& other)
+	{
+		for (int i = 0; i < NumBuckets; ++i)
+		{
+			uint64_t c = other.GetBucketCount(i);
+			if (c) counts[i].fetch_add(c, std::memory_order_relaxed);
+		}
+		total.fetch_add(other.GetCount(), std::memory_order_relaxed);
+		uint64_t om = other.GetMax();
+		uint64_t m = maxValue.load(std::memory_order_relaxed);
+		while (om > m && !maxValue.compare_exchange_weak(m, om, std::memory_order_relaxed)) {}
+	}
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "lmspsc.h"
+
+/*
+ʷͼõĵƽժҪƵ߳ÿ N  Push һUI ÿ֡ Pop µļµ
+˾Ͷݣ༭ûʱû˶Ƶ߳
+*/
+
+struct LMHistoryFrame
+{
+	float inMin, inMax;//루˹input棩ĲС/ֵ
+	float outMin, outMax;//С/ֵ
+	float gainAdd;//һ gainAddѹ = 20*log10(1+gainAdd)
+};
+
+template<int Capacity>
+using LMHistoryRing = LMSpscRing<LMHistoryFrame, Capacity>;
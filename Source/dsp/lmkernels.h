@@ -0,0 +1,80 @@
+#pragma once
+
+#include <math.h>
+
+#include "lmsimd.h"
+#include "lmcpu.h"
+
+/*
+lmkernels: LMLimiter Ǽѭָһݣʱѡ
+硢ֵЩǵƣָ޹أ lmlimiter.h 
+ͬһݴ lmkernels_isa.h ÿָһΣ x86 ƽֻ̨ scalar һݣԼ
+а汾ָͬֻǿͬ
+*/
+
+#define LMK_NS scalar
+#define LMK_VEC LMLimiterNamespace::simd::scalar::Vec
+#define LMK_FN
+#include "lmkernels_isa.h"
+#undef LMK_NS
+#undef LMK_VEC
+#undef LMK_FN
+
+#if LMSIMD_X86
+#define LMK_NS sse2
+#define LMK_VEC LMLimiterNamespace::simd::sse2::Vec
+#define LMK_FN LMSIMD_SSE2_FN
+#include "lmkernels_isa.h"
+#undef LMK_NS
+#undef LMK_VEC
+#undef LMK_FN
+
+#define LMK_NS avx2
+#define LMK_VEC LMLimiterNamespace::simd::avx2::Vec
+#define LMK_FN LMSIMD_AVX2_FN
+#include "lmkernels_isa.h"
+#undef LMK_NS
+#undef LMK_VEC
+#undef LMK_FN
+
+#define LMK_NS avx512
+#define LMK_VEC LMLimiterNamespace::simd::avx512::Vec
+#define LMK_FN LMSIMD_AVX512_FN
+#include "lmkernels_isa.h"
+#undef LMK_NS
+#undef LMK_VEC
+#undef LMK_FN
+#endif
+
+namespace LMLimiterNamespace
+{
+	struct StageKernels
+	{
+		cpu::Isa isa;
+		void (*Detect)(const float* inL, const float* inR, float* l, float* r, float* vl, float* vr,
+			float inputMul, float thresholdMul, int n);
+		void (*ApplyGain)(const float* dlyL, const float* dlyR, const float* gainL, const float* gainR,
+			float* outL, float* outR, int n);
+		void (*Output)(const float* clipL, const float* clipR, float* outL, float* outR,
+			float thresholdMul, float outputMul, int n);
+	};
+
+	//isa ƽ̨ķΧʱ˵õһ
+	inline const StageKernels& GetStageKernels(cpu::Isa isa)
+	{
+		using cpu::Isa;
+		static const StageKernels table[] = {
+			{ Isa::Scalar, kernels::scalar::Detect, kernels::scalar::ApplyGain, kernels::scalar::Output },
+#if LMSIMD_X86
+			{ Isa::SSE2, kernels::sse2::Detect, kernels::sse2::ApplyGain, kernels::sse2::Output },
+			{ Isa::AVX2, kernels::avx2::Detect, kernels::avx2::ApplyGain, kernels::avx2::Output },
+			{ Isa::AVX512, kernels::avx512::Detect, kernels::avx512::ApplyGain, kernels::avx512::Output },
+#endif
+		};
+		const int count = sizeof(table) / sizeof(table[0]);
+		int index = (int)isa;
+		if (index < 0) index = 0;
+		if (index >= count) index = count - 1;
+		return table[index];
+	}
+}
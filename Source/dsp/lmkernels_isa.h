@@ -0,0 +1,80 @@
+//lmkernels_isa.hû #pragma once lmkernels.h ָһ
+//֮ǰ LMK_NSռ䣩LMK_VECͣLMK_FNָ target ԣ
+//鰴ߣʣ²һ߱ߵ˳ LMLimiter ԭıѭһͬ
+
+namespace LMLimiterNamespace
+{
+	namespace kernels
+	{
+		namespace LMK_NS
+		{
+			using V = LMK_VEC;
+
+			//⣺桢ֵ 1 Ĳ
+			LMK_FN inline void Detect(const float* inL, const float* inR, float* l, float* r, float* vl, float* vr,
+				float inputMul, float thresholdMul, int n)
+			{
+				const V im = V::Set(inputMul), th = V::Set(thresholdMul), one = V::Set(1.0f), zero = V::Set(0.0f);
+				int i = 0;
+				for (; i + V::Width <= n; i += V::Width)
+				{
+					V a = V::Load(inL + i) * im / th;
+					V b = V::Load(inR + i) * im / th;
+					a.Store(l + i);
+					b.Store(r + i);
+					Max(Abs(a) - one, zero).Store(vl + i);
+					Max(Abs(b) - one, zero).Store(vr + i);
+				}
+				for (; i < n; ++i)
+				{
+					l[i] = inL[i] * inputMul / thresholdMul;
+					r[i] = inR[i] * inputMul / thresholdMul;
+					float vl1 = fabsf(l[i]) - 1.0f;
+					float vr1 = fabsf(r[i]) - 1.0f;
+					vl[i] = (vl1 > 0) ? vl1 : 0;
+					vr[i] = (vr1 > 0) ? vr1 : 0;
+				}
+			}
+
+			//ʩ棺ʱźų 1 + gainAdd
+			LMK_FN inline void ApplyGain(const float* dlyL, const float* dlyR, const float* gainL, const float* gainR,
+				float* outL, float* outR, int n)
+			{
+				const V one = V::Set(1.0f);
+				int i = 0;
+				for (; i + V::Width <= n; i += V::Width)
+				{
+					(V::Load(dlyL + i) / (one + V::Load(gainL + i))).Store(outL + i);
+					(V::Load(dlyR + i) / (one + V::Load(gainR + i))).Store(outR + i);
+				}
+				for (; i < n; ++i)
+				{
+					outL[i] = dlyL[i] / (1.0f + gainL[i]);
+					outR[i] = dlyR[i] / (1.0f + gainR[i]);
+				}
+			}
+
+			//е [-1, 1]˻ֵ
+			LMK_FN inline void Output(const float* clipL, const float* clipR, float* outL, float* outR,
+				float thresholdMul, float outputMul, int n)
+			{
+				const V one = V::Set(1.0f), minusOne = V::Set(-1.0f), th = V::Set(thresholdMul), om = V::Set(outputMul);
+				int i = 0;
+				for (; i + V::Width <= n; i += V::Width)
+				{
+					(Max(Min(V::Load(clipL + i), one), minusOne) * th * om).Store(outL + i);
+					(Max(Min(V::Load(clipR + i), one), minusOne) * th * om).Store(outR + i);
+				}
+				for (; i < n; ++i)
+				{
+					float outl = clipL[i] < 1.0f ? clipL[i] : 1.0f;// MaxF(MinF(x, 1), -1) һ
+					float outr = clipR[i] < 1.0f ? clipR[i] : 1.0f;
+					outl = outl > -1.0f ? outl : -1.0f;
+					outr = outr > -1.0f ? outr : -1.0f;
+					outL[i] = outl * thresholdMul * outputMul;
+					outR[i] = outr * thresholdMul * outputMul;
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,10 @@
+#include "lmlimiter.h"
+#include "lmlimiter_batch.h"
+
+//lmlimiter_dsp: JUCE̬⣬ǲķ˳
+//ͷļģʵһΣ֤ lmlimiter.h  JuceHeader.h 
+
+template class LMLimiterNamespace::TinyDelay<4800>;
+template class LMLimiterNamespace::SlidingWindowMax<4800>;
+template class LMLimiterBatch<8>;
+template class LMLimiterBatch<16>;
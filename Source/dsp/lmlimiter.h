@@ -2,48 +2,195 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <string.h>
+#include <atomic>
+
+#include "lmtrace.h"
+#include "lmhistory.h"
+#include "lmfastmath.h"
+#include "lmkernels.h"
 
 namespace LMLimiterNamespace
 {
+	//a  NaN ʱ b if (a > b) b = a дһ
+	inline float MaxF(float a, float b) { return a > b ? a : b; }
+	inline float MinF(float a, float b) { return a < b ? a : b; }
+
+	//ʱ建壺һֱ MaxDelaySamples 룬ͷÿ GlideRate ٶȻµʱ
+	//мСλԲֵ൱ڶݵı٣䣩ͣԺʱԭ鿽
 	template<int MaxDelaySamples>
 	class TinyDelay
 	{
 	private:
 		float buf[MaxDelaySamples] = { 0 };
-		int delaySamples = 0;
-		int pos = 0;
+		int delaySamples = 0;//ĿʱҲǱʱ
+		int writePos = 0;//һҪдλ
+		float readDelay = 0.0f;//ʵʵĶʱ
+		bool gliding = false;
+		bool fresh = true;//Reset Ժûȫ0ʱֱȥ
 	public:
+		static constexpr float GlideRate = 1.0f / 16.0f;//Լһı2ݣͣ
+		static constexpr int BufferSize = MaxDelaySamples;
+
 		TinyDelay()
 		{
 			memset(buf, 0, sizeof(buf));
 		}
 		void SetDelaySamples(int numSamples)
 		{
-			if (delaySamples == numSamples) return;
 			if (numSamples < 0)numSamples = 0;
 			if (numSamples >= MaxDelaySamples) numSamples = MaxDelaySamples - 1;
+			if (delaySamples == numSamples) return;
 			delaySamples = numSamples;
+			if (fresh) readDelay = (float)numSamples;
+			else gliding = true;
+		}
+		int GetDelaySamples() const
+		{
+			return delaySamples;
+		}
+		//λ壬 M/S лʱ͵ػ
+		float* GetBuffer() { return buf; }
+		void Reset()
+		{
 			memset(buf, 0, sizeof(buf));
+			writePos = 0;
+			readDelay = (float)delaySamples;
+			gliding = false;
+			fresh = true;
 		}
 		float ProcessSample(float inSample)
 		{
-			buf[(pos + delaySamples) % MaxDelaySamples] = inSample;
-			float outSample = buf[pos];
-			pos = (pos + 1) % MaxDelaySamples;
+			float outSample;
+			ProcessBlock(&inSample, &outSample, 1);
 			return outSample;
 		}
+		// lookahead ĳͷҪͬһ ProcessBlock ֮ǰ
+		//Ķʱÿڱ䣬ͷͬĹ켣ߣͬԲֵʼղ lookahead 
+		void ReadTap(const float* in, float* out, int lookahead, int numSamples) const
+		{
+			if (gliding)
+			{
+				ReadGlideTap(in, out, lookahead, numSamples);
+				return;
+			}
+			int tapDelay = delaySamples - lookahead;
+			if (tapDelay < 0) tapDelay = 0;
+			int fromBuf = numSamples < tapDelay ? numSamples : tapDelay;
+			int readPos = writePos - tapDelay;
+			if (readPos < 0) readPos += MaxDelaySamples;
+			for (int i = 0; i < fromBuf; ++i)
+			{
+				int idx = readPos + i;
+				if (idx >= MaxDelaySamples) idx -= MaxDelaySamples;
+				out[i] = buf[idx];
+			}
+			for (int i = fromBuf; i < numSamples; ++i)
+			{
+				out[i] = in[i - tapDelay];
+			}
+		}
+		//numSamples 峤ȣin  out ͬһڴ
+		void ProcessBlock(const float* in, float* out, int numSamples)
+		{
+			fresh = false;
+			if (gliding)
+			{
+				ProcessGlide(in, out, numSamples);
+				return;
+			}
+			//ǰ delaySamples Ի壨ǰдȥģֱӾǱǰ
+			int fromBuf = numSamples < delaySamples ? numSamples : delaySamples;
+			int readPos = writePos - delaySamples;
+			if (readPos < 0) readPos += MaxDelaySamples;
+			for (int i = 0; i < fromBuf; ++i)
+			{
+				int idx = readPos + i;
+				if (idx >= MaxDelaySamples) idx -= MaxDelaySamples;
+				out[i] = buf[idx];
+			}
+			for (int i = fromBuf; i < numSamples; ++i)
+			{
+				out[i] = in[i - delaySamples];
+			}
+			for (int i = 0; i < numSamples; ++i)
+			{
+				int idx = writePos + i;
+				if (idx >= MaxDelaySamples) idx -= MaxDelaySamples;
+				buf[idx] = in[i];
+			}
+			writePos = (writePos + numSamples) % MaxDelaySamples;
+		}
+	private:
+		// k k < 0 ǰдģ
+		float SampleAt(const float* in, int k) const
+		{
+			if (k >= 0) return in[k];
+			int idx = writePos + k;
+			if (idx < 0) idx += MaxDelaySamples;
+			return buf[idx];
+		}
+		//ReadTap Ļ汾ʱĹ켣 ProcessGlide һֻǲ״̬
+		void ReadGlideTap(const float* in, float* out, int lookahead, int numSamples) const
+		{
+			const float target = (float)delaySamples;
+			float d = readDelay;
+			for (int i = 0; i < numSamples; ++i)
+			{
+				float tap = d - lookahead;
+				if (tap < 0) tap = 0;//ʱڱ䳤 lookaheadֻܶǰ
+				int id = (int)tap;
+				float frac = tap - id;
+				float s0 = SampleAt(in, i - id);
+				float s1 = SampleAt(in, i - id - 1);
+				out[i] = s0 + frac * (s1 - s0);
+
+				if (d < target) d = d + GlideRate < target ? d + GlideRate : target;
+				else d = d - GlideRate > target ? d - GlideRate : target;
+			}
+		}
+		//дٰСʱʱĿһ˾ͻص·
+		void ProcessGlide(const float* in, float* out, int numSamples)
+		{
+			const float target = (float)delaySamples;
+			float d = readDelay;
+			int w = writePos;
+			for (int i = 0; i < numSamples; ++i)
+			{
+				buf[w] = in[i];
+				int id = (int)d;
+				float frac = d - id;
+				int i0 = w - id;
+				if (i0 < 0) i0 += MaxDelaySamples;
+				int i1 = i0 == 0 ? MaxDelaySamples - 1 : i0 - 1;
+				out[i] = buf[i0] + frac * (buf[i1] - buf[i0]);
+				if (++w == MaxDelaySamples) w = 0;
+
+				if (d < target) d = d + GlideRate < target ? d + GlideRate : target;
+				else d = d - GlideRate > target ? d - GlideRate : target;
+			}
+			readDelay = d;
+			writePos = w;
+			if (d == target) gliding = false;
+		}
 	};
 
+	template<int MaxWindowSize>
 	class SlidingWindowMax {
 	private:
 		struct Sample {
-			long long index;
+			unsigned int index;//ҲûϵֻȽ currentIndex - index
 			float value;
 		};
 
-		std::deque<Sample> deque;
+		//зڶƵ߳ﲻκڴ
+		Sample deque[MaxWindowSize + 2];
+		int head = 0, tail = 0;//[head, tail)
 		int windowSize;
-		long long currentIndex;
+		unsigned int currentIndex;
+
+		static int Next(int i) { return i == MaxWindowSize + 1 ? 0 : i + 1; }
+		static int Prev(int i) { return i == 0 ? MaxWindowSize + 1 : i - 1; }
 
 	public:
 		SlidingWindowMax() : windowSize(0), currentIndex(0) {}
@@ -56,26 +203,182 @@ namespace LMLimiterNamespace
 			if (numSamples < 1) {
 				numSamples = 1;
 			}
-			windowSize = numSamples;
-			deque.clear();
+			if (numSamples > MaxWindowSize) {
+				numSamples = MaxWindowSize;
+			}
+			windowSize = numSamples;//Уʱڵһӣ䳤ʱµЧ
+		}
+
+		void Reset() {
+			head = tail = 0;
 			currentIndex = 0;
 		}
 
 		float ProcessSample(float x) {
-			while (!deque.empty() && deque.back().value <= x) {
-				deque.pop_back();
+			return ProcessSpan(x, 1);
+		}
+
+		//x ǽ numSamples ֵʡģʽһ飩Ȼ㣺
+		//һһ뿪ʱγӣһĶҲʵ
+		float ProcessSpan(float x, int numSamples) {
+			while (head != tail && deque[Prev(tail)].value <= x) {
+				tail = Prev(tail);
 			}
 
-			deque.push_back({ currentIndex, x });
+			currentIndex += numSamples - 1;
+			deque[tail] = { currentIndex, x };
+			tail = Next(tail);
 
-			if (deque.front().index <= currentIndex - windowSize) {
-				deque.pop_front();
+			while (currentIndex - deque[head].index >= (unsigned int)windowSize) {
+				head = Next(head);
 			}
 
 			currentIndex++;
 
-			if (deque.empty()) return 0;//ֹdeque
-			return deque.front().value;
+			if (head == tail) return 0;//ֹdeque
+			return deque[head].value;
+		}
+	};
+
+	//ƽλ + ۼӺͣÿ O(1)ͳ޹
+	//ۼӺ doubleӽȥͼȥͬһ floatʱҲƯ
+	//尴󳤶ȴ룬ĳʱֻѶ/ٵǼӽ/ۼӺͣ״̬
+	template<int MaxLength>
+	class BoxFilter
+	{
+	private:
+		float buf[MaxLength] = { 0 };
+		int length = 1;
+		int pos = 0;//һҪдλ
+		double sum = 0;
+		double invLength = 1.0;
+
+		int Back(int k) const//k ǰдλã1 <= k <= MaxLength
+		{
+			int idx = pos - k;
+			return idx < 0 ? idx + MaxLength : idx;
+		}
+	public:
+		void SetLength(int numSamples)
+		{
+			if (numSamples < 1) numSamples = 1;
+			if (numSamples > MaxLength) numSamples = MaxLength;
+			if (length == numSamples) return;
+			double acc = sum;
+			for (int k = length + 1; k <= numSamples; ++k) acc += buf[Back(k)];
+			for (int k = numSamples + 1; k <= length; ++k) acc -= buf[Back(k)];
+			sum = acc;
+			length = numSamples;
+			invLength = 1.0 / length;
+		}
+		int GetLength() const
+		{
+			return length;
+		}
+		void Reset()
+		{
+			memset(buf, 0, sizeof(buf));
+			pos = 0;
+			sum = 0;
+		}
+		//ԭش
+		void ProcessBlock(float* x, int numSamples)
+		{
+			//дλöƵĶδѭûз֧
+			int rd = Back(length);
+			for (int i = 0; i < numSamples;)
+			{
+				int seg = numSamples - i;
+				if (seg > MaxLength - pos) seg = MaxLength - pos;
+				if (seg > MaxLength - rd) seg = MaxLength - rd;
+				double acc = sum;
+				float* w = buf + pos;
+				const float* r = buf + rd;
+				for (int j = 0; j < seg; ++j)
+				{
+					acc += (double)x[i + j] - r[j];
+					w[j] = x[i + j];
+					x[i + j] = (float)(acc * invLength);
+				}
+				sum = acc;
+				i += seg;
+				pos += seg;
+				if (pos == MaxLength) pos = 0;
+				rd += seg;
+				if (rd == MaxLength) rd = 0;
+			}
+		}
+	};
+
+	//ȫ knee һ׷ADAA
+	//ֻĲв r(x) = f(x) - x  ADAA r = 0뱾û ADAA İͨ
+	//֤ |x| <= 1r  [0, 1] Ϻ x ţԿҲᳬ 1
+	//f|x| <= 1-k ԣ1-k ~ 1+k ιɣ>= 1+k Ӳ 1k = 0 Ӳ
+	class ADAAClipper
+	{
+	private:
+		float knee = 0.0f;
+		float kneeStart = 1.0f;//1-k
+		float hardConst = -0.5f;//|x| >= 1+k ηĳ
+		float lastX = 0.0f, lastR = 0.0f;
+
+		float Residual(float x) const
+		{
+			float ax = fabsf(x);
+			if (ax <= kneeStart) return 0.0f;
+			float r = ax >= 1.0f + knee ? 1.0f - ax : -(ax - kneeStart) * (ax - kneeStart) / (4.0f * knee);
+			return x < 0 ? -r : r;
+		}
+		//вķż
+		float ResidualAD(float x) const
+		{
+			float ax = fabsf(x);
+			if (ax <= kneeStart) return 0.0f;
+			if (ax >= 1.0f + knee) return ax - 0.5f * ax * ax + hardConst;
+			float d = ax - kneeStart;
+			return -d * d * d / (12.0f * knee);
+		}
+	public:
+		//kneeWidth0 ~ 0.5Է
+		void SetKnee(float kneeWidth)
+		{
+			if (kneeWidth < 1e-6f) kneeWidth = 0.0f;
+			if (kneeWidth > 0.5f) kneeWidth = 0.5f;
+			if (kneeWidth == knee) return;
+			knee = kneeWidth;
+			kneeStart = 1.0f - knee;
+			float b = 1.0f + knee;
+			hardConst = -2.0f * knee * knee / 3.0f - b + 0.5f * b * b;// 1+k Ͷζν
+			lastR = ResidualAD(lastX);
+		}
+		void Reset()
+		{
+			lastX = lastR = 0.0f;
+		}
+		//ԭش
+		void ProcessBlock(float* x, int numSamples)
+		{
+			float x0 = lastX, r0 = lastR;
+			for (int i = 0; i < numSamples; ++i)
+			{
+				float x1 = x[i];
+				float ax0 = fabsf(x0), ax1 = fabsf(x1);
+				if (ax0 <= kneeStart && ax1 <= kneeStart)
+				{
+					//˶вķ 0
+					x0 = x1;
+					r0 = 0.0f;
+					continue;
+				}
+				float r1 = ResidualAD(x1);
+				float dx = x1 - x0;
+				float res = fabsf(dx) > 1e-5f ? (r1 - r0) / dx : Residual(0.5f * (x0 + x1));
+				x[i] = x1 + res;
+				x0 = x1;
+				r0 = r1;
+			}
+			lastX = x0;
+			lastR = r0;
 		}
 	};
 
@@ -127,7 +430,9 @@ namespace LMLimiterNamespace
 	};
 }
 
+#ifndef WithEditor
 #define WithEditor 1
+#endif
 
 class LMLimiter {
 private:
@@ -135,8 +440,8 @@ private:
 
 	LMLimiterNamespace::TinyDelay<4800> delayL;//100msʱ
 	LMLimiterNamespace::TinyDelay<4800> delayR;
-	LMLimiterNamespace::SlidingWindowMax swmL;
-	LMLimiterNamespace::SlidingWindowMax swmR;
+	LMLimiterNamespace::SlidingWindowMax<4800> swmL;
+	LMLimiterNamespace::SlidingWindowMax<4800> swmR;
 
 	float inputMul = 1.0, outputMul = 1.0, thresholdMul = 1.0;
 
@@ -148,28 +453,137 @@ private:
 	float attackTaw = 0.0f;
 	float releaseTaw = 0.0f;//releaseһһ׵ͨ
 
+	//Ӧreleaseֵ/Чֵreleaseܼزķŵһ㣬ٵʧ
+	//ֵ;ÿһεƣO(1)ɱÿӿһ
+	static constexpr float CrestTimeMs = 200.0f;//ֵ˥ƽʱ䳣
+	static constexpr float CrestLowLog2 = 1.0f;//ʲ log21 = 3dBң°
+	static constexpr float CrestHighLog2 = 5.0f;//5 = 15dBϲ
+	static constexpr float MaxReleaseOctaves = 3.0f;// 2^3 = 8 
+	float adaptiveRelease = 0.0f;//0~10 ԭĹ̶release
+	float crestPeak2 = 0.0f, crestMeanSq = 0.0f;//ֵƽ
+	float crestPeakDecay = 0.0f, crestMeanCoeff = 0.0f;
+	float releaseScale = 1.0f;//˵ releaseTaw 
+
+	//ƽattackֵٹƽܳ <= ʱ-1һ
+	//ʱÿʱƽĿһѾ >= Ҫû۽
+	//ģʽ attack ã״ȫ lookahead 
+	static constexpr int SmoothStages = 3;
+	static constexpr int MaxBoxLength = 4800 / SmoothStages + 2;
+	LMLimiterNamespace::BoxFilter<MaxBoxLength> boxL[SmoothStages];
+	LMLimiterNamespace::BoxFilter<MaxBoxLength> boxR[SmoothStages];
+	float boxLastL = 0, boxLastR = 0;//һ
+	bool smoothAttack = false;
+
+	//ʡģʽͰÿ economyFactor һΣʩӵԲֵ
+	//ֵڣڰ㣨ʱȡٶһ飩ӿĩβһĶΰʵʳȹڣֵ©
+	//ֵĵطձף컨岻䡣ģʽƽattack
+	static constexpr int MaxEconomyFactor = 32;
+	int economyFactor = 1;//1 = 
+	//ʱټӽ
+	using EcoWindowMax = LMLimiterNamespace::SlidingWindowMax<4800 + 2 * MaxEconomyFactor>;
+	EcoWindowMax ecoSwmL;
+	EcoWindowMax ecoSwmR;
+
+	//ģʽleveler+ 켶ԭcatcherһʱߣʱ
+	//ʱڼ⣬ûлڣ attack/release һ׵ͨڳڣ
+	//Ȼǰʱ켶ʱмĳͷϼ⣨Ѿ˹棩ֻúһʱǰհ
+	//ˣձԳź컨岻
+	bool twoStage = false;
+	float levelerMul = 1.0f;//ֵ threshold
+	float levelerAttack = 0.0f, levelerRelease = 0.0f;//һ׵ͨϵ
+	float levelL = 0, levelR = 0;// gainAdd
+	int lookaheadWindow = 0;//ʱڵĳ
+
+	LMLimiterNamespace::ADAAClipper clipperL;
+	LMLimiterNamespace::ADAAClipper clipperR;
+
+	//M/S ģʽL ͨУ(L+R)/2R ͨܲࣨ(L-R)/2ڼѭѭһ黺
+	//С threshold ƫƣ컨ֱкͲϣ L/R ֮ͣ
+	bool midSide = false;
+	float midMul = 1.0f, sideMul = 1.0f;
+
+	//ļѭָɣlmkernels.hĬ CPU ֵ֧һ
+	//SetIsa ڱ̣߳ý棩ãProcessBlock ÿһΣͬһ
+	std::atomic<const LMLimiterNamespace::StageKernels*> kernels{ &LMLimiterNamespace::GetStageKernels(LMLimiterNamespace::cpu::DetectIsa()) };
+
 	bool isRisingL = false;
 	bool isRisingR = false;
 
 #if WithEditor
-	using ThreadSafeFloat = std::atomic<float>;
-	float maxInputdB = 0.0f;//ƽinputdB棩
-	float maxOutputdB = 0.0f;//ƽoutputdB棩
-	float maxThresholddB = 0.0f;//ֵƽ
-	float maxReductiondB = 0.0f;//ѹȥ
-	ThreadSafeFloat lastMaxInputdB = -1000.0f;
-	ThreadSafeFloat lastMaxOutputdB = -1000.0f;
-	ThreadSafeFloat lastMaxThresholddB = -1000.0f;
-	ThreadSafeFloat lastMaxReductiondB = -1000.0f;
+	//ͷƵ߳ۼƣÿ MeterWindowSamples һֵƽٴ㿪ʼ
+	//һ༭ / C APIֻӶȡȡļȡٻdB߲дͬһ
+	struct MeterWindow
+	{
+		float absIn, absOut, thresholdMul, gainAdd;
+	};
+	static constexpr int MeterWindowSamples = 1024;
+	LMSpscRing<MeterWindow, 64> meterWindows;//48kHz Լ 1.4 룬һͣøþͶµĴ
+	//Ƶ߳
 	int updateCounter = 0;
+	float maxAbsIn = 0, maxAbsOut = 0, maxThresholdMul = 0, maxGainAdd = 0;//һĿǰΪֵֹ
+	//һ
+	float lastMaxInputdB = -1000.0f;//ƽinputdB棩
+	float lastMaxOutputdB = -1000.0f;//ƽoutputdB棩
+	float lastMaxThresholddB = -1000.0f;//ֵƽ
+	float lastMaxReductiondB = -1000.0f;//ѹȥ
+
+public:
+	static constexpr int HistoryColumnsPerSecond = 100;//ʷͼÿ
+	using HistoryRing = LMHistoryRing<1024>;
+private:
+	HistoryRing history;
+	LMHistoryFrame historyFrame = EmptyHistoryFrame();
+	int historyCounter = 0;
+	int historyDecimation = 480;
+	static LMHistoryFrame EmptyHistoryFrame() { return { 1e30f, -1e30f, 1e30f, -1e30f, 0.0f }; }
 #endif
 
 public:
+	void SetSampleRate(float newSampleRate)
+	{
+		sampleRate = newSampleRate;
+		crestPeakDecay = expf(-1000.0f / (CrestTimeMs * sampleRate));
+		crestMeanCoeff = 1.0f - crestPeakDecay;
+#if WithEditor
+		historyDecimation = (int)(sampleRate / HistoryColumnsPerSecond);
+		if (historyDecimation < 1) historyDecimation = 1;
+#endif
+	}
+	void Reset()
+	{
+		delayL.Reset();
+		delayR.Reset();
+		swmL.Reset();
+		swmR.Reset();
+		gainAddL = gainAddR = 0;
+		crestPeak2 = crestMeanSq = 0;
+		releaseScale = 1.0f;
+		ResetBoxes();
+		ecoSwmL.Reset();
+		ecoSwmR.Reset();
+		levelL = levelR = 0;
+		clipperL.Reset();
+		clipperR.Reset();
+	}
+	int GetLatencySamples() const
+	{
+		return delayL.GetDelaySamples();
+	}
+	//һںˣƵֻ߳ͬǿͬ
+	void SetIsa(LMLimiterNamespace::cpu::Isa isa)
+	{
+		kernels.store(&LMLimiterNamespace::GetStageKernels(isa), std::memory_order_release);
+	}
+	LMLimiterNamespace::cpu::Isa GetIsa() const
+	{
+		return kernels.load(std::memory_order_acquire)->isa;
+	}
 	void SetParams(float lookahead, float inputdB, float outputdB, float thresholddB, float attackMs, float releaseMs)
 	{
-		inputMul = powf(10.0f, inputdB / 20.0f);
-		outputMul = powf(10.0f, outputdB / 20.0f);
-		thresholdMul = powf(10.0f, thresholddB / 20.0f);
+		LMTRACE_SCOPE("LMLimiter::SetParams");
+		inputMul = LMLimiterNamespace::DbToGain(inputdB);
+		outputMul = LMLimiterNamespace::DbToGain(outputdB);
+		thresholdMul = LMLimiterNamespace::DbToGain(thresholddB);
 
 		attackTaw = 1.0 / lookaheadSamples;//lookaheadʱĿֵ,Ȼٶٳһattackʱ䳣
 		attackTaw *= (1.0 + attackMs / 1000.0);//ӦattackMs(λ)
@@ -177,111 +591,598 @@ public:
 
 		float lookaheadSamples = lookahead * sampleRate / 1000.0f + 2.0;
 		if (lookaheadSamples > 4800.0f) lookaheadSamples = 4800.0f;
+		//ͣʱȡǱʱСֻڻĹõ
 		delayL.SetDelaySamples(lookaheadSamples);
 		delayR.SetDelaySamples(lookaheadSamples);
-		swmL.SetWindowSize(lookaheadSamples);
-		swmR.SetWindowSize(lookaheadSamples);
+		lookaheadWindow = (int)lookaheadSamples;
+		UpdateWindows();
+	}
+	//ȫ kneeֵ kneedB ʼ0 Ӳ0 ~ 6dB
+	void SetClipKnee(float kneedB)
+	{
+		if (kneedB < 0.0f) kneedB = 0.0f;
+		if (kneedB > 6.0f) kneedB = 6.0f;
+		float k = 1.0f - LMLimiterNamespace::DbToGain(-kneedB);
+		clipperL.SetKnee(k);
+		clipperR.SetKnee(k);
+	}
+	//M/S ģʽmidOffsetdB/sideOffsetdB Сֵ threshold ƫ
+	void SetMidSide(bool enabled, float midOffsetdB, float sideOffsetdB)
+	{
+		float newMid = LMLimiterNamespace::DbToGain(midOffsetdB);
+		float newSide = LMLimiterNamespace::DbToGain(sideOffsetdB);
+		if (enabled != midSide)
+		{
+			//ʱ͵ػ㵽µлʱϣ lookahead ʱԼϣձ
+			float* bl = delayL.GetBuffer();
+			float* br = delayR.GetBuffer();
+			for (int i = 0; i < delayL.BufferSize; ++i)
+			{
+				float l = bl[i], r = br[i];
+				if (enabled)
+				{
+					bl[i] = (l + r) * 0.5f / newMid;
+					br[i] = (l - r) * 0.5f / newSide;
+				}
+				else
+				{
+					bl[i] = l * midMul + r * sideMul;
+					br[i] = l * midMul - r * sideMul;
+				}
+			}
+			clipperL.Reset();
+			clipperR.Reset();
+			midSide = enabled;
+		}
+		midMul = newMid;
+		sideMul = newSide;
 	}
-	void ProcessBlock(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	//ģʽthresholdOffsetdB ֵ threshold ƫƣһ <= 0attack/release Լ
+	void SetLeveler(bool enabled, float thresholdOffsetdB, float attackMs, float releaseMs)
 	{
-		//ʱŻѭĳ˷Ԥȼ
-		for (int i = 0; i < numSamples; ++i)
+		if (enabled != twoStage)
 		{
-			float inl = inL[i] * inputMul / thresholdMul;
-			float inr = inR[i] * inputMul / thresholdMul;
-			float vl1 = fabsf(inl) - 1.0;
-			float vr1 = fabsf(inr) - 1.0;
-			vl1 = (vl1 > 0) ? vl1 : 0;
-			vr1 = (vr1 > 0) ? vr1 : 0;
+			twoStage = enabled;
+			levelL = levelR = 0;
+			UpdateWindows();
+		}
+		if (attackMs < 0.1f) attackMs = 0.1f;
+		if (releaseMs < 0.1f) releaseMs = 0.1f;
+		levelerMul = LMLimiterNamespace::DbToGain(-thresholdOffsetdB);
+		//1 - e^(-1/N) = 1 - 2^(-log2(e)/N)
+		levelerAttack = 1.0f - LMLimiterNamespace::FastExp2(-1.442695f / (attackMs * sampleRate / 1000.0f));
+		levelerRelease = 1.0f - LMLimiterNamespace::FastExp2(-1.442695f / (releaseMs * sampleRate / 1000.0f));
+	}
+	//ÿٸһΰ磺1 رգ 32
+	void SetEconomy(int factor)
+	{
+		if (factor < 1) factor = 1;
+		if (factor > MaxEconomyFactor) factor = MaxEconomyFactor;
+		if (factor == economyFactor) return;
+		//лʱһ·ĻǾɵģ
+		if ((factor > 1) != (economyFactor > 1))
+		{
+			swmL.Reset();
+			swmR.Reset();
+			ecoSwmL.Reset();
+			ecoSwmR.Reset();
+		}
+		economyFactor = factor;
+		UpdateWindows();
+	}
+	//trueattack üƽƽfalseԭ
+	void SetSmoothAttack(bool enabled)
+	{
+		if (enabled && !smoothAttack) ResetBoxes();//´ʱ㿪ʼͷձ
+		smoothAttack = enabled;
+	}
+	//amount 0~10 رգ1 ʱ͵ 3dB زrelease8
+	void SetAdaptiveRelease(float amount)
+	{
+		adaptiveRelease = amount < 0.0f ? 0.0f : (amount > 1.0f ? 1.0f : amount);
+		if (adaptiveRelease == 0.0f) releaseScale = 1.0f;
+	}
+	//keyL/keyRⲿ˾⣨ƣֱӶźʱߣձԿź
+	void ProcessBlock(const float* inL, const float* inR, float* outL, float* outR, int numSamples,
+		const float* keyL = nullptr, const float* keyR = nullptr)
+	{
+		LMTRACE_SCOPE("LMLimiter::ProcessBlock");
+		const LMLimiterNamespace::StageKernels* kern = kernels.load(std::memory_order_acquire);
+		//೤гɹ̶ȵӿ飬ÿӿ鰴׶θһѭм scratch 
+		for (int start = 0; start < numSamples; start += SubBlockSize)
+		{
+			int n = numSamples - start < SubBlockSize ? numSamples - start : SubBlockSize;
+			ProcessSubBlock(*kern, inL + start, inR + start, outL + start, outR + start, n,
+				keyL ? keyL + start : nullptr, keyR ? keyR + start : nullptr);
+		}
+	}
 
-			float smaxL = swmL.ProcessSample(vl1);//㻬ֵ
-			float smaxR = swmR.ProcessSample(vr1);
-			float dlyL = delayL.ProcessSample(inl);//ʱ
-			float dlyR = delayR.ProcessSample(inr);
+private:
+	static constexpr int SubBlockSize = 64;
+	struct alignas(64) Scratch //һ2.5KBһֱL1
+	{
+		float inl[SubBlockSize], inr[SubBlockSize];//˹桢ֵ
+		float vl[SubBlockSize], vr[SubBlockSize];//ֵĲ
+		float smaxL[SubBlockSize], smaxR[SubBlockSize];//ֵƽattackʱƽĿ꣩
+		float dlyL[SubBlockSize], dlyR[SubBlockSize];//ʱ
+		float gainL[SubBlockSize], gainR[SubBlockSize];//ÿ gainAdd
+		float levelL[SubBlockSize], levelR[SubBlockSize];//ģʽ棨˷
+		float tapL[SubBlockSize], tapR[SubBlockSize];//ģʽ켶ĳͷ֮ų˹ʱ
+		float clipL[SubBlockSize], clipR[SubBlockSize];//ǰ󣨹һֵ
+	} scratch;
 
-			if (smaxL > gainAddL)
+	//켶Ӽ㵽ڵʱΣǺһ
+	int CatcherDelay() const
+	{
+		int delay = delayL.GetDelaySamples();
+		if (!twoStage) return delay;
+		return delay / 2 < 1 ? 1 : delay / 2;
+	}
+
+	//ڡƽattackʡģʽĳȶſ켶ʱ
+	void UpdateWindows()
+	{
+		int delay = CatcherDelay();
+		int window = twoStage ? delay : lookaheadWindow;
+		swmL.SetWindowSize(window);
+		swmR.SetWindowSize(window);
+
+		//ȼ1 = ʱ-1ָǰ
+		int span = delay - 1;
+		if (span < 0) span = 0;
+		for (int k = 0; k < SmoothStages; ++k)
+		{
+			int len = 1 + span / SmoothStages + (k < span % SmoothStages ? 1 : 0);
+			boxL[k].SetLength(len);
+			boxR[k].SetLength(len);
+		}
+
+		int groups = (delay + economyFactor - 1) / economyFactor + 1;
+		ecoSwmL.SetWindowSize(groups * economyFactor);
+		ecoSwmR.SetWindowSize(groups * economyFactor);
+	}
+
+	void RunLeveler(const float* in, float inMul, float* level, float& state, int n)
+	{
+		float g = state;
+		for (int i = 0; i < n; ++i)
+		{
+			float v = fabsf(in[i]) * inMul - 1.0f;
+			v = v > 0 ? v : 0;
+			g += (v > g ? levelerAttack : levelerRelease) * (v - g);
+			level[i] = 1.0f / (1.0f + g);
+		}
+		state = g;
+	}
+
+	void ResetBoxes()
+	{
+		for (int k = 0; k < SmoothStages; ++k)
+		{
+			boxL[k].Reset();
+			boxR[k].Reset();
+		}
+		boxLastL = boxLastR = 0;
+	}
+
+	//ֵԭػƽĿ
+	static void SmoothTarget(float* x, LMLimiterNamespace::BoxFilter<MaxBoxLength>* box, float& last, int n)
+	{
+		for (int k = 0; k < SmoothStages; ++k) box[k].ProcessBlock(x, n);
+		float carry = last;
+		for (int i = 0; i < n; ++i)
+		{
+			float y = x[i];
+			x[i] = carry;
+			carry = y;
+		}
+		last = carry;
+	}
+
+	//ǵƵģֻ
+	template<bool Smooth>
+	void RunEnvelope(const float* smax, const float* dly, float* gain, float& gainAdd, int n)
+	{
+		float g = gainAdd;
+		float release = releaseTaw * releaseScale;
+		for (int i = 0; i < n; ++i)
+		{
+			if (smax[i] > g)
 			{
-				gainAddL += smaxL * attackTaw;//lookaheadʱĿֵ
-				if (gainAddL > smaxL) gainAddL = smaxL;
+				if (Smooth)
+				{
+					g = smax[i];//ĿѾƽģֱӸ
+				}
+				else
+				{
+					g += smax[i] * attackTaw;//lookaheadʱĿֵ
+					if (g > smax[i]) g = smax[i];
+				}
 			}
 			else
 			{
-				gainAddL += releaseTaw * (smaxL - gainAddL);
-				//if (gainAddL < smaxL) gainAddL = smaxL;
+				g += release * (smax[i] - g);
 			}
-			if (smaxR > gainAddR)
+			//ձlookaheadû׼õǿ
+			float dlyv = fabsf(dly[i]) - 1.0;
+			if (dlyv > g) g = dlyv;
+			gain[i] = g;
+		}
+		gainAdd = g;
+	}
+
+	//ʡģʽİ磺ÿ economyFactor ȡһֵڵĻֵ
+	//һһ飬ʩӵһֵԲ嵽һֵձȻ
+	void RunEconomy(const float* v, const float* dly, float* gain, float& gainAdd, EcoWindowMax& swm, int n)
+	{
+		using LMLimiterNamespace::MaxF;
+		float g = gainAdd;
+		float logKeep = LMLimiterNamespace::FastLog2(1.0f - releaseTaw * releaseScale);//release ÿı
+		for (int start = 0; start < n; start += economyFactor)
+		{
+			int m = n - start < economyFactor ? n - start : economyFactor;
+			float vmax = 0;
+			for (int i = 0; i < m; ++i) vmax = MaxF(v[start + i], vmax);
+			float smax = swm.ProcessSpan(vmax, m);
+
+			float g0 = g;
+			if (smax > g)
 			{
-				gainAddR += smaxR * attackTaw;//lookaheadʱĿֵ
-				if (gainAddR > smaxR) gainAddR = smaxR;
+				g += smax * attackTaw * m;//һ m 
+				if (g > smax) g = smax;
 			}
 			else
 			{
-				gainAddR += releaseTaw * (smaxR - gainAddR);
-				//if (gainAddR < smaxR) gainAddR = smaxR;
+				g = smax + (g - smax) * LMLimiterNamespace::FastExp2(m * logKeep);//һ׵ͨ m 
 			}
 
-			//ձlookaheadû׼õǿ
-			float dlyvl = fabsf(dlyL) - 1.0;
-			float dlyvr = fabsf(dlyR) - 1.0;
-			if (dlyvl > gainAddL) gainAddL = dlyvl;
-			if (dlyvr > gainAddR) gainAddR = dlyvr;
+			float step = (g - g0) / m;
+			float held = g;
+			for (int i = 0; i < m; ++i)
+			{
+				float gi = g0 + step * (i + 1);
+				//ձֵĲǿȥǽ磬ϵȥ
+				float dlyv = fabsf(dly[start + i]) - 1.0f;
+				if (dlyv > gi)
+				{
+					gi = dlyv;
+					held = MaxF(dlyv, held);
+				}
+				gain[start + i] = gi;
+			}
+			g = held;
+		}
+		gainAdd = g;
+	}
 
-			float outl = dlyL / (1.0f + gainAddL);
-			float outr = dlyR / (1.0f + gainAddR);
-			if (outl > 1.0f) outl = 1.0f;//ɣ
-			if (outl < -1.0f) outl = -1.0f;
+	//M/S ģʽļ⣺롢һһѭꣻвʱҲ룬һŽ tap 
+	void DetectMidSide(const float* inL, const float* inR, const float* keyL, const float* keyR, int n)
+	{
+		Scratch& s = scratch;
+		const float thrM = thresholdMul * midMul, thrS = thresholdMul * sideMul;
+		if (!keyL)
+		{
+			for (int i = 0; i < n; ++i)
+			{
+				s.inl[i] = (inL[i] + inR[i]) * 0.5f * inputMul / thrM;
+				s.inr[i] = (inL[i] - inR[i]) * 0.5f * inputMul / thrS;
+				float vl1 = fabsf(s.inl[i]) - 1.0f;
+				float vr1 = fabsf(s.inr[i]) - 1.0f;
+				s.vl[i] = (vl1 > 0) ? vl1 : 0;
+				s.vr[i] = (vr1 > 0) ? vr1 : 0;
+			}
+		}
+		else
+		{
+			for (int i = 0; i < n; ++i)
+			{
+				s.inl[i] = (inL[i] + inR[i]) * 0.5f * inputMul / thrM;
+				s.inr[i] = (inL[i] - inR[i]) * 0.5f * inputMul / thrS;
+				s.tapL[i] = (keyL[i] + keyR[i]) * 0.5f / thrM;
+				s.tapR[i] = (keyL[i] - keyR[i]) * 0.5f / thrS;
+				float vl1 = fabsf(s.tapL[i]) - 1.0f;
+				float vr1 = fabsf(s.tapR[i]) - 1.0f;
+				s.vl[i] = (vl1 > 0) ? vl1 : 0;
+				s.vr[i] = (vr1 > 0) ? vr1 : 0;
+			}
+		}
+	}
+
+	void UpdateCrest(const float* l, const float* r, int n)
+	{
+		using LMLimiterNamespace::MaxF;
+		float pk = crestPeak2, ms = crestMeanSq;
+		for (int i = 0; i < n; ++i)
+		{
+			float x2 = MaxF(l[i] * l[i], r[i] * r[i]) + 1e-30f;//һףʱ
+			ms += crestMeanCoeff * (x2 - ms);
+			pk = MaxF(x2, pk * crestPeakDecay);
+		}
+		crestPeak2 = pk;
+		crestMeanSq = ms;
 
-			outL[i] = outl * thresholdMul * outputMul;//Ӧ油
-			outR[i] = outr * thresholdMul * outputMul;
+		float crest = LMLimiterNamespace::FastLog2(pk / ms);
+		float slow = (CrestHighLog2 - crest) / (CrestHighLog2 - CrestLowLog2);
+		slow = slow < 0.0f ? 0.0f : (slow > 1.0f ? 1.0f : slow);
+		releaseScale = LMLimiterNamespace::FastExp2(-adaptiveRelease * MaxReleaseOctaves * slow);
+	}
+
+	void ProcessSubBlock(const LMLimiterNamespace::StageKernels& kern, const float* inL, const float* inR, float* outL, float* outR, int n,
+		const float* keyL, const float* keyR)
+	{
+		Scratch& s = scratch;
+		if (keyL && !keyR) keyR = keyL;//߹
+
+		//1. ⣺桢ֵ
+		const float* levelKeyL = keyL;
+		const float* levelKeyR = keyR;
+		float levelKeyMul = levelerMul / thresholdMul;
+		{
+			LMTRACE_SCOPE("LMLimiter::Detect");
+			if (midSide)
+			{
+				DetectMidSide(inL, inR, keyL, keyR, n);
+				levelKeyL = s.tapL;//M/S һĲ
+				levelKeyR = s.tapR;
+				levelKeyMul = levelerMul;
+			}
+			else if (!keyL)
+			{
+				kern.Detect(inL, inR, s.inl, s.inr, s.vl, s.vr, inputMul, thresholdMul, n);
+			}
+			else
+			{
+				//ֱӶĲ棬ֵֻ
+				const float keyMul = 1.0f / thresholdMul;
+				for (int i = 0; i < n; ++i)
+				{
+					s.inl[i] = inL[i] * inputMul / thresholdMul;
+					s.inr[i] = inR[i] * inputMul / thresholdMul;
+					float vl1 = fabsf(keyL[i]) * keyMul - 1.0f;
+					float vr1 = fabsf(keyR[i]) * keyMul - 1.0f;
+					s.vl[i] = (vl1 > 0) ? vl1 : 0;
+					s.vr[i] = (vr1 > 0) ? vr1 : 0;
+				}
+			}
+
+			if (adaptiveRelease > 0.0f)
+			{
+				if (keyL) UpdateCrest(keyL, keyR, n);//ֵֻùһ
+				else UpdateCrest(s.inl, s.inr, n);
+			}
+		}
+
+		//1b. ģʽ棨вʱɲ켶ʱмĳͷϼ⣬ͷȳ
+		if (twoStage)
+		{
+			LMTRACE_SCOPE("LMLimiter::Leveler");
+			if (keyL)
+			{
+				RunLeveler(levelKeyL, levelKeyMul, s.levelL, levelL, n);
+				RunLeveler(levelKeyR, levelKeyMul, s.levelR, levelR, n);
+			}
+			else
+			{
+				RunLeveler(s.inl, levelerMul, s.levelL, levelL, n);
+				RunLeveler(s.inr, levelerMul, s.levelR, levelR, n);
+			}
+			//ͷ CatcherDelay lookahead 仯ʱʵʶʱһ
+			delayL.ReadTap(s.inl, s.tapL, CatcherDelay(), n);
+			delayR.ReadTap(s.inr, s.tapR, CatcherDelay(), n);
+			for (int i = 0; i < n; ++i)
+			{
+				float vl1 = fabsf(s.tapL[i] * s.levelL[i]) - 1.0f;
+				float vr1 = fabsf(s.tapR[i] * s.levelR[i]) - 1.0f;
+				s.vl[i] = (vl1 > 0) ? vl1 : 0;
+				s.vr[i] = (vr1 > 0) ? vr1 : 0;
+			}
+		}
+
+		const bool economy = economyFactor > 1;
+		if (!economy)
+		{
+			LMTRACE_SCOPE("LMLimiter::SlidingMax");
+			//2. ֵ
+			for (int i = 0; i < n; ++i) s.smaxL[i] = swmL.ProcessSample(s.vl[i]);
+			for (int i = 0; i < n; ++i) s.smaxR[i] = swmR.ProcessSample(s.vr[i]);
+
+			//2b. ƽattackĿƽ
+			if (smoothAttack)
+			{
+				SmoothTarget(s.smaxL, boxL, boxLastL, n);
+				SmoothTarget(s.smaxR, boxR, boxLastR, n);
+			}
+		}
+
+		const float* envDlyL = s.dlyL;
+		const float* envDlyR = s.dlyR;
+		//3. ʱ
+		{
+			LMTRACE_SCOPE("LMLimiter::Delay");
+			delayL.ProcessBlock(s.inl, s.dlyL, n);
+			delayR.ProcessBlock(s.inr, s.dlyR, n);
+
+			//3b. ģʽ켶ձҪ˹źţŽ tap 
+			if (twoStage)
+			{
+				for (int i = 0; i < n; ++i)
+				{
+					s.tapL[i] = s.dlyL[i] * s.levelL[i];
+					s.tapR[i] = s.dlyR[i] * s.levelR[i];
+				}
+				envDlyL = s.tapL;
+				envDlyR = s.tapR;
+			}
+		}
+
+		//4. 
+		{
+			LMTRACE_SCOPE("LMLimiter::Envelope");
+			if (economy)
+			{
+				//ʡģʽֵͰ綼㣨22b 
+				RunEconomy(s.vl, envDlyL, s.gainL, gainAddL, ecoSwmL, n);
+				RunEconomy(s.vr, envDlyR, s.gainR, gainAddR, ecoSwmR, n);
+			}
+			else if (smoothAttack)
+			{
+				RunEnvelope<true>(s.smaxL, envDlyL, s.gainL, gainAddL, n);
+				RunEnvelope<true>(s.smaxR, envDlyR, s.gainR, gainAddR, n);
+			}
+			else
+			{
+				RunEnvelope<false>(s.smaxL, envDlyL, s.gainL, gainAddL, n);
+				RunEnvelope<false>(s.smaxR, envDlyR, s.gainR, gainAddR, n);
+			}
+
+			//4b. ģʽϳһ gainAdd(1+g) / level - 1ʩӺ͵ƽø
+			if (twoStage)
+			{
+				for (int i = 0; i < n; ++i)
+				{
+					s.gainL[i] = (1.0f + s.gainL[i]) / s.levelL[i] - 1.0f;
+					s.gainR[i] = (1.0f + s.gainR[i]) / s.levelR[i] - 1.0f;
+				}
+			}
+		}
+
+		//5. ʩ
+		{
+			LMTRACE_SCOPE("LMLimiter::ApplyGain");
+			kern.ApplyGain(s.dlyL, s.dlyR, s.gainL, s.gainR, s.clipL, s.clipR, n);
+		}
+
+		using LMLimiterNamespace::MaxF;
+		using LMLimiterNamespace::MinF;
+
+		//6. ȫ knee + ADAAӲһΣס
+		{
+			LMTRACE_SCOPE("LMLimiter::ClipOutput");
+			clipperL.ProcessBlock(s.clipL, n);
+			clipperR.ProcessBlock(s.clipR, n);
+			if (!midSide)
+			{
+				kern.Output(s.clipL, s.clipR, outL, outR, thresholdMul, outputMul, n);//Ӧ油
+			}
+			else
+			{
+				//M/S 油ͬһѭ
+				const float mulM = thresholdMul * midMul * outputMul, mulS = thresholdMul * sideMul * outputMul;
+				for (int i = 0; i < n; ++i)
+				{
+					float m = MaxF(MinF(s.clipL[i], 1.0f), -1.0f) * mulM;
+					float sd = MaxF(MinF(s.clipR[i], 1.0f), -1.0f) * mulS;
+					outL[i] = m + sd;
+					outR[i] = m - sd;
+				}
+			}
+		}
 
 #if WithEditor
-			float absInL = fabsf(inl * thresholdMul);
-			float inLdB = 20.0f * log10f(absInL + 1e-60);
-			if (inLdB > maxInputdB) maxInputdB = inLdB;
-
-			float absInR = fabsf(inr * thresholdMul);
-			float inRdB = 20.0f * log10f(absInR + 1e-60);
-			if (inRdB > maxInputdB) maxInputdB = inRdB;
-
-			float absOutL = fabsf(outL[i]);
-			float outLdB = 20.0f * log10f(absOutL + 1e-60);
-			if (outLdB > maxOutputdB) maxOutputdB = outLdB;
-
-			float absOutR = fabsf(outR[i]);
-			float outRdB = 20.0f * log10f(absOutR + 1e-60);
-			if (outRdB > maxOutputdB) maxOutputdB = outRdB;
-
-			float thresholddB = 20.0f * log10f(thresholdMul + 1e-60);
-			if (thresholddB > maxThresholddB) maxThresholddB = thresholddB;
-			float reductionL = 20.0f * log10f(1.0f + gainAddL);
-			if (reductionL > maxReductiondB) maxReductiondB = reductionL;
-			float reductionR = 20.0f * log10f(1.0f + gainAddR);
-			if (reductionR > maxReductiondB) maxReductiondB = reductionR;
-			updateCounter++;
-#endif
+		//7. ͷӿֻȡ󣬻dBŵ GetMeterValues log ȡһ
+		// MaxF/MinF  fmaxf/fminf fast-math ʱǺãѭҲˣ
+		//ƽ L/R 㣬M/S ģʽ½ȥ
+		{
+			LMTRACE_SCOPE("LMLimiter::Meters");
+			const float inMulL = midSide ? thresholdMul * midMul : thresholdMul;
+			const float inMulR = midSide ? thresholdMul * sideMul : thresholdMul;
+			auto inputLR = [&](int i, float& l, float& r)
+			{
+				l = s.inl[i] * inMulL;
+				r = s.inr[i] * inMulR;
+				if (midSide)
+				{
+					float m = l;
+					l = m + r;
+					r = m - r;
+				}
+			};
+			float absIn = maxAbsIn, absOut = maxAbsOut, gain = maxGainAdd;
+			for (int i = 0; i < n; ++i)
+			{
+				float inLv, inRv;
+				inputLR(i, inLv, inRv);
+				absIn = MaxF(MaxF(fabsf(inLv), fabsf(inRv)), absIn);
+				absOut = MaxF(MaxF(fabsf(outL[i]), fabsf(outR[i])), absOut);
+				gain = MaxF(MaxF(s.gainL[i], s.gainR[i]), gain);
+			}
+			maxAbsIn = absIn;
+			maxAbsOut = absOut;
+			maxGainAdd = gain;
+			maxThresholdMul = MaxF(thresholdMul, maxThresholdMul);
+			updateCounter += n;
+			if (updateCounter >= MeterWindowSamples)
+			{
+				meterWindows.Push({ maxAbsIn, maxAbsOut, maxThresholdMul, maxGainAdd });
+				maxAbsIn = maxAbsOut = maxThresholdMul = maxGainAdd = 0;
+				updateCounter = 0;
+			}
 
+			//ʷͼÿ historyDecimation һС//ѹժҪ
+			for (int i = 0; i < n;)
+			{
+				int m = historyDecimation - historyCounter;
+				if (m > n - i) m = n - i;
+				if (m < 1) m = 1;
+				for (int k = i; k < i + m; ++k)
+				{
+					float inLv, inRv;
+					inputLR(k, inLv, inRv);
+					historyFrame.inMin = MinF(MinF(inLv, inRv), historyFrame.inMin);
+					historyFrame.inMax = MaxF(MaxF(inLv, inRv), historyFrame.inMax);
+					historyFrame.outMin = MinF(MinF(outL[k], outR[k]), historyFrame.outMin);
+					historyFrame.outMax = MaxF(MaxF(outL[k], outR[k]), historyFrame.outMax);
+					historyFrame.gainAdd = MaxF(MaxF(s.gainL[k], s.gainR[k]), historyFrame.gainAdd);
+				}
+				i += m;
+				historyCounter += m;
+				if (historyCounter >= historyDecimation)
+				{
+					history.Push(historyFrame);
+					historyFrame = EmptyHistoryFrame();
+					historyCounter = 0;
+				}
+			}
 		}
+#endif
 	}
 
+public:
 #if WithEditor
+	//ֻһ̶߳༭ʱ C API ĵ÷ϴζԺû´ͷϴεֵ
 	void GetMeterValues(float& inputdB, float& outputdB, float& thresholddB, float& reductiondB)
 	{
-		if (updateCounter >= 1024)
-		{
-			lastMaxInputdB.store(maxInputdB);
-			lastMaxOutputdB.store(maxOutputdB);
-			lastMaxThresholddB.store(maxThresholddB);
-			lastMaxReductiondB.store(maxReductiondB);
-			maxInputdB = -1000.0f;
-			maxOutputdB = -1000.0f;
-			maxThresholddB = -1000.0f;
-			maxReductiondB = -1000.0f;
-			updateCounter = 0;
-		}
-		inputdB = lastMaxInputdB.load();
-		outputdB = lastMaxOutputdB.load();
-		thresholddB = lastMaxThresholddB.load();
-		reductiondB = lastMaxReductiondB.load();
+		using LMLimiterNamespace::MaxF;
+		MeterWindow windows[16];
+		MeterWindow peak{ 0, 0, 0, 0 };
+		bool received = false;
+		int n;
+		while ((n = meterWindows.Pop(windows, 16)) > 0)
+		{
+			received = true;
+			for (int i = 0; i < n; ++i)
+			{
+				peak.absIn = MaxF(windows[i].absIn, peak.absIn);
+				peak.absOut = MaxF(windows[i].absOut, peak.absOut);
+				peak.thresholdMul = MaxF(windows[i].thresholdMul, peak.thresholdMul);
+				peak.gainAdd = MaxF(windows[i].gainAdd, peak.gainAdd);
+			}
+		}
+		if (received)
+		{
+			lastMaxInputdB = LMLimiterNamespace::GainToDb(peak.absIn);
+			lastMaxOutputdB = LMLimiterNamespace::GainToDb(peak.absOut);
+			lastMaxThresholddB = LMLimiterNamespace::GainToDb(peak.thresholdMul);
+			lastMaxReductiondB = LMLimiterNamespace::GainToDb(1.0f + peak.gainAdd);
+		}
+		inputdB = lastMaxInputdB;
+		outputdB = lastMaxOutputdB;
+		thresholddB = lastMaxThresholddB;
+		reductiondB = lastMaxReductiondB;
+	}
+	HistoryRing& GetHistory()
+	{
+		return history;
 	}
 #endif
 
@@ -0,0 +1,350 @@
+#pragma once
+
+#include <atomic>
+
+#include "lmlimiter.h"
+#include "lmsimd.h"
+#include "lmcpu.h"
+#include "lmfastmath.h"
+
+/*
+LMLimiterBatch: һͬʱ Lanes ·˵ã
+״̬ [][lane] ųɽṹ飬ÿlaneȫͬ㣬
+ѭ lmlimiter_batch_isa.h ﰴָһݣʱѡSetIsaĬ SelectIsa()
+һδ Vec::Width ·SSE2 4·AVX2 8·AVX-512 16· Lanes ָ˵һ8·batchAVX-512AVX2
+
+ LMLimiter 
+- lookahead batchãʱinput/output/threshold/attack/release ÿ·
+- ֵ÷ֿ van Herk/Gil-Werman 浥У
+  ͵ȫһ£ûصķ֧Կlane
+- ƽֻÿʱһdBlmfastmath  GainToDbѭlog10f
+-  lookahead ʱߣLMLimiter Ửȥû M/Sʡģʽ
+ÿһ·Ͳοʵ֣tests/lmreference.h lmlimiter_golden 飻 LMLimiter ֤λͬ
+˳ȫһָ֮λͬ
+
+ú֮û˳ҪSetSampleRate ᰴĺֵ lookahead ÿһ·ϵ
+*/
+
+namespace LMLimiterNamespace
+{
+	template<int Lanes, int MaxDelaySamples>
+	class LaneDelay
+	{
+	private:
+		alignas(64) float buf[MaxDelaySamples][Lanes];
+		int delaySamples = 0;
+		int pos = 0;
+	public:
+		LaneDelay()
+		{
+			memset(buf, 0, sizeof(buf));
+		}
+		void SetDelaySamples(int numSamples)
+		{
+			if (delaySamples == numSamples) return;
+			if (numSamples < 0)numSamples = 0;
+			if (numSamples >= MaxDelaySamples) numSamples = MaxDelaySamples - 1;
+			delaySamples = numSamples;
+			memset(buf, 0, sizeof(buf));
+		}
+		int GetDelaySamples() const
+		{
+			return delaySamples;
+		}
+		void Reset()
+		{
+			memset(buf, 0, sizeof(buf));
+			pos = 0;
+		}
+		//ֻǰݣ memcpy Լչ
+		void ProcessSample(const float* in, float* out)
+		{
+			int wpos = pos + delaySamples;
+			if (wpos >= MaxDelaySamples) wpos -= MaxDelaySamples;
+			memcpy(buf[wpos], in, sizeof(buf[wpos]));
+			memcpy(out, buf[pos], sizeof(buf[pos]));
+			if (++pos == MaxDelaySamples) pos = 0;
+		}
+	};
+
+	//һ lmlimiter_batch_isa.h  WindowMaxSample ҪָࣩԳԱǹ
+	template<int Lanes, int MaxWindowSize>
+	struct LaneWindowMax
+	{
+		//block[cur]: ǰдԭʼֵ
+		//block[cur ^ 1]: һĺ׺ֵ[windowSize]0Ϊڱ
+		// = һ[phase+1, W) + ǰ[0, phase] max = max(׺[phase+1], ǰǰ׺max)
+		alignas(64) float block[2][MaxWindowSize + 1][Lanes];
+		alignas(64) float prefix[Lanes];
+		int cur = 0;
+		int phase = 0;
+		int windowSize = 0;
+
+		LaneWindowMax()
+		{
+			Reset();
+		}
+		void SetWindowSize(int numSamples)
+		{
+			if (windowSize == numSamples) return;
+			if (numSamples < 1) numSamples = 1;
+			if (numSamples > MaxWindowSize) numSamples = MaxWindowSize;
+			windowSize = numSamples;
+			Reset();
+		}
+		void Reset()
+		{
+			memset(block, 0, sizeof(block));//붼>=00ȼ"û"
+			memset(prefix, 0, sizeof(prefix));
+			cur = 0;
+			phase = 0;
+		}
+	};
+
+	//LMLimiterBatch ѭҪõȫ״̬ںֱӶд
+	template<int Lanes>
+	struct BatchState
+	{
+		static constexpr int ChunkFrames = 64;
+
+		LaneDelay<Lanes, 4800> delayL;
+		LaneDelay<Lanes, 4800> delayR;
+		LaneWindowMax<Lanes, 4800> swmL;
+		LaneWindowMax<Lanes, 4800> swmR;
+
+		alignas(64) float inputMul[Lanes];
+		alignas(64) float outputMul[Lanes];
+		alignas(64) float thresholdMul[Lanes];
+		alignas(64) float attackTaw[Lanes];
+		alignas(64) float releaseTaw[Lanes];
+		alignas(64) float gainAddL[Lanes];
+		alignas(64) float gainAddR[Lanes];
+
+		//һchunkתû [][lane]
+		alignas(64) float xL[ChunkFrames][Lanes];
+		alignas(64) float xR[ChunkFrames][Lanes];
+
+		alignas(64) float peakIn[Lanes];
+		alignas(64) float peakOut[Lanes];
+		alignas(64) float peakGain[Lanes];
+	};
+}
+
+#define LMK_NS scalar
+#define LMK_VEC LMLimiterNamespace::simd::scalar::Vec
+#define LMK_FN
+#include "lmlimiter_batch_isa.h"
+#undef LMK_NS
+#undef LMK_VEC
+#undef LMK_FN
+
+#if LMSIMD_X86
+#define LMK_NS sse2
+#define LMK_VEC LMLimiterNamespace::simd::sse2::Vec
+#define LMK_FN LMSIMD_SSE2_FN
+#include "lmlimiter_batch_isa.h"
+#undef LMK_NS
+#undef LMK_VEC
+#undef LMK_FN
+
+#define LMK_NS avx2
+#define LMK_VEC LMLimiterNamespace::simd::avx2::Vec
+#define LMK_FN LMSIMD_AVX2_FN
+#include "lmlimiter_batch_isa.h"
+#undef LMK_NS
+#undef LMK_VEC
+#undef LMK_FN
+
+#define LMK_NS avx512
+#define LMK_VEC LMLimiterNamespace::simd::avx512::Vec
+#define LMK_FN LMSIMD_AVX512_FN
+#include "lmlimiter_batch_isa.h"
+#undef LMK_NS
+#undef LMK_VEC
+#undef LMK_FN
+#endif
+
+namespace LMLimiterNamespace
+{
+	template<int Lanes>
+	struct BatchKernel
+	{
+		cpu::Isa isa;
+		int width;
+		void (*ProcessChunk)(BatchState<Lanes>& state, int n);
+	};
+
+	//isa ƽ̨ķΧ Lanes ʱ˵õһ
+	template<int Lanes>
+	inline const BatchKernel<Lanes>& GetBatchKernel(cpu::Isa isa)
+	{
+		using cpu::Isa;
+		static const BatchKernel<Lanes> table[] = {
+			{ Isa::Scalar, simd::scalar::Vec::Width, kernels::scalar::BatchChunk<Lanes> },
+#if LMSIMD_X86
+			{ Isa::SSE2, simd::sse2::Vec::Width, kernels::sse2::BatchChunk<Lanes> },
+			{ Isa::AVX2, simd::avx2::Vec::Width, kernels::avx2::BatchChunk<Lanes> },
+			{ Isa::AVX512, simd::avx512::Vec::Width, kernels::avx512::BatchChunk<Lanes> },
+#endif
+		};
+		const int count = sizeof(table) / sizeof(table[0]);
+		int index = (int)isa;
+		if (index < 0) index = 0;
+		if (index >= count) index = count - 1;
+		while (index > 0 && Lanes % table[index].width != 0) --index;
+		return table[index];
+	}
+}
+
+template<int Lanes>
+class LMLimiterBatch
+{
+private:
+	static constexpr int ChunkFrames = LMLimiterNamespace::BatchState<Lanes>::ChunkFrames;
+	static constexpr float LookaheadSamples = 480.0f;//attack Ļ׼LMLimiterһ£̶ֵ lookahead 䣩
+
+	float sampleRate = 48000.0;
+	float lookaheadMs = 5.0f;
+	//ÿһ·ʱĺֵSetSampleRate ϵ
+	float attackMs[Lanes];
+	float releaseMs[Lanes];
+
+	LMLimiterNamespace::BatchState<Lanes> state;
+	//SetIsa ڱ̣߳ý棩ãProcessBlock ÿһ
+	std::atomic<const LMLimiterNamespace::BatchKernel<Lanes>*> kernel{ &LMLimiterNamespace::GetBatchKernel<Lanes>(LMLimiterNamespace::cpu::SelectIsa()) };
+
+	std::atomic<float> lastInputdB[Lanes];
+	std::atomic<float> lastOutputdB[Lanes];
+	std::atomic<float> lastReductiondB[Lanes];
+
+	void UpdateLaneCoefficients(int lane)
+	{
+		state.attackTaw[lane] = 1.0 / LookaheadSamples;
+		state.attackTaw[lane] *= (1.0 + attackMs[lane] / 1000.0);
+		state.releaseTaw[lane] = 1.0f / (releaseMs[lane] * sampleRate / 1000.0f);
+	}
+
+	void UpdateLookahead()
+	{
+		float lookaheadSamples = lookaheadMs * sampleRate / 1000.0f + 2.0;
+		if (lookaheadSamples > 4800.0f) lookaheadSamples = 4800.0f;
+		state.delayL.SetDelaySamples(lookaheadSamples);
+		state.delayR.SetDelaySamples(lookaheadSamples);
+		state.swmL.SetWindowSize(lookaheadSamples);
+		state.swmR.SetWindowSize(lookaheadSamples);
+	}
+
+public:
+	LMLimiterBatch()
+	{
+		for (int k = 0; k < Lanes; ++k)
+		{
+			lastInputdB[k].store(-1000.0f);
+			lastOutputdB[k].store(-1000.0f);
+			lastReductiondB[k].store(0.0f);
+		}
+		Reset();
+		for (int k = 0; k < Lanes; ++k) SetLaneParams(k, 0, 0, 0, 1, 10);
+		SetLookahead(5);
+	}
+
+	static constexpr int GetNumLanes() { return Lanes; }
+
+	void SetSampleRate(float newSampleRate)
+	{
+		sampleRate = newSampleRate;
+		UpdateLookahead();
+		for (int k = 0; k < Lanes; ++k) UpdateLaneCoefficients(k);
+	}
+	void Reset()
+	{
+		state.delayL.Reset();
+		state.delayR.Reset();
+		state.swmL.Reset();
+		state.swmR.Reset();
+		for (int k = 0; k < Lanes; ++k)
+		{
+			state.gainAddL[k] = state.gainAddR[k] = 0;
+			state.peakIn[k] = state.peakOut[k] = state.peakGain[k] = 0;
+		}
+	}
+	int GetLatencySamples() const
+	{
+		return state.delayL.GetDelaySamples();
+	}
+	//ѡһָںˣһֻǿͬ Lanes ʱõһ
+	void SetIsa(LMLimiterNamespace::cpu::Isa isa)
+	{
+		kernel.store(&LMLimiterNamespace::GetBatchKernel<Lanes>(isa), std::memory_order_release);
+	}
+	LMLimiterNamespace::cpu::Isa GetIsa() const
+	{
+		return kernel.load(std::memory_order_acquire)->isa;
+	}
+	void SetLookahead(float lookahead)
+	{
+		lookaheadMs = lookahead;
+		UpdateLookahead();
+	}
+	void SetLaneParams(int lane, float inputdB, float outputdB, float thresholddB, float attack, float release)
+	{
+		state.inputMul[lane] = LMLimiterNamespace::DbToGain(inputdB);
+		state.outputMul[lane] = LMLimiterNamespace::DbToGain(outputdB);
+		state.thresholdMul[lane] = LMLimiterNamespace::DbToGain(thresholddB);
+		attackMs[lane] = attack;
+		releaseMs[lane] = release;
+		UpdateLaneCoefficients(lane);
+	}
+
+	//inL/inR/outL/outR  Lanes ָͨ룬nullptr ʾһ·У뵱д
+	//ͬһڴ
+	void ProcessBlock(const float* const* inL, const float* const* inR, float* const* outL, float* const* outR, int numSamples)
+	{
+		const LMLimiterNamespace::BatchKernel<Lanes>* k = kernel.load(std::memory_order_acquire);
+		for (int done = 0; done < numSamples; done += ChunkFrames)
+		{
+			int n = numSamples - done < ChunkFrames ? numSamples - done : ChunkFrames;
+			for (int lane = 0; lane < Lanes; ++lane)
+			{
+				const float* l = inL[lane];
+				const float* r = inR[lane];
+				if (l) for (int i = 0; i < n; ++i) state.xL[i][lane] = l[done + i];
+				else for (int i = 0; i < n; ++i) state.xL[i][lane] = 0.0f;
+				if (r) for (int i = 0; i < n; ++i) state.xR[i][lane] = r[done + i];
+				else for (int i = 0; i < n; ++i) state.xR[i][lane] = 0.0f;
+			}
+
+			k->ProcessChunk(state, n);
+
+			for (int lane = 0; lane < Lanes; ++lane)
+			{
+				float* l = outL[lane];
+				float* r = outR[lane];
+				if (l) for (int i = 0; i < n; ++i) l[done + i] = state.xL[i][lane];
+				if (r) for (int i = 0; i < n; ++i) r[done + i] = state.xR[i][lane];
+			}
+		}
+
+		float indB[Lanes], outdB[Lanes], reddB[Lanes];
+		for (int lane = 0; lane < Lanes; ++lane)
+		{
+			indB[lane] = LMLimiterNamespace::GainToDb(state.peakIn[lane] * state.thresholdMul[lane]);
+			outdB[lane] = LMLimiterNamespace::GainToDb(state.peakOut[lane]);
+			reddB[lane] = LMLimiterNamespace::GainToDb(1.0f + state.peakGain[lane]);
+		}
+		for (int lane = 0; lane < Lanes; ++lane)
+		{
+			lastInputdB[lane].store(indB[lane]);
+			lastOutputdB[lane].store(outdB[lane]);
+			lastReductiondB[lane].store(reddB[lane]);
+			state.peakIn[lane] = state.peakOut[lane] = state.peakGain[lane] = 0;
+		}
+	}
+
+	void GetMeterValues(int lane, float& inputdB, float& outputdB, float& reductiondB) const
+	{
+		inputdB = lastInputdB[lane].load();
+		outputdB = lastOutputdB[lane].load();
+		reductiondB = lastReductiondB[lane].load();
+	}
+};
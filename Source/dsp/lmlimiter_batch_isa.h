@@ -0,0 +1,107 @@
+//lmlimiter_batch_isa.hû #pragma once lmlimiter_batch.h ָһΣ lmkernels_isa.h һ
+//֮ǰ LMK_NSռ䣩LMK_VECͣLMK_FNָ target ԣ
+//ÿlaneͬ㣬һ LMK_VEC::Width ·GetBatchKernel ֻڿ Lanes ʱѡһ
+
+namespace LMLimiterNamespace
+{
+	namespace kernels
+	{
+		namespace LMK_NS
+		{
+			//ֵһ
+			template<int Lanes, int MaxWindowSize>
+			LMK_FN inline void WindowMaxSample(LaneWindowMax<Lanes, MaxWindowSize>& w, const float* x, float* out)
+			{
+				using V = LMK_VEC;
+				float* c = w.block[w.cur][w.phase];
+				const float* s = w.block[w.cur ^ 1][w.phase + 1];
+				for (int k = 0; k < Lanes; k += V::Width)
+				{
+					V v = V::Load(x + k);
+					V p = Max(v, V::Load(w.prefix + k));
+					v.Store(c + k);
+					p.Store(w.prefix + k);
+					Max(V::Load(s + k), p).Store(out + k);
+				}
+				if (++w.phase == w.windowSize)
+				{
+					//ǰдԭرɺ׺ֵһʹã̯ÿһmax
+					float(*b)[Lanes] = w.block[w.cur];
+					memset(b[w.windowSize], 0, sizeof(b[w.windowSize]));
+					for (int j = w.windowSize - 1; j >= 0; --j)
+						for (int k = 0; k < Lanes; k += V::Width)
+							Max(V::Load(b[j] + k), V::Load(b[j + 1] + k)).Store(b[j] + k);
+					memset(w.prefix, 0, sizeof(w.prefix));
+					w.cur ^= 1;
+					w.phase = 0;
+				}
+			}
+
+			//һ chunkn <= ChunkFrames Ѿתý xL/xRԭش
+			template<int Lanes>
+			LMK_FN void BatchChunkBody(BatchState<Lanes>& b, int n)
+			{
+				using V = LMK_VEC;
+				alignas(64) float vl1[Lanes], vr1[Lanes];
+				alignas(64) float smaxL[Lanes], smaxR[Lanes];
+				alignas(64) float dlyL[Lanes], dlyR[Lanes];
+				const V zero = V::Set(0.0f), one = V::Set(1.0f), minusOne = V::Set(-1.0f);
+
+				for (int i = 0; i < n; ++i)
+				{
+					float* sL = b.xL[i];
+					float* sR = b.xR[i];
+					for (int k = 0; k < Lanes; k += V::Width)
+					{
+						V inl = V::Load(sL + k) * V::Load(b.inputMul + k) / V::Load(b.thresholdMul + k);
+						V inr = V::Load(sR + k) * V::Load(b.inputMul + k) / V::Load(b.thresholdMul + k);
+						inl.Store(sL + k);
+						inr.Store(sR + k);
+						V al = Abs(inl), ar = Abs(inr);
+						Max(Max(al, ar), V::Load(b.peakIn + k)).Store(b.peakIn + k);
+						Max(al - one, zero).Store(vl1 + k);
+						Max(ar - one, zero).Store(vr1 + k);
+					}
+
+					WindowMaxSample(b.swmL, vl1, smaxL);
+					WindowMaxSample(b.swmR, vr1, smaxR);
+					b.delayL.ProcessSample(sL, dlyL);
+					b.delayR.ProcessSample(sR, dlyR);
+
+					for (int k = 0; k < Lanes; k += V::Width)
+					{
+						// LMLimiter ͬİ磬֧ĳselect
+						V att = V::Load(b.attackTaw + k), rel = V::Load(b.releaseTaw + k);
+						V sl = V::Load(smaxL + k), sr = V::Load(smaxR + k);
+						V gl = V::Load(b.gainAddL + k), gr = V::Load(b.gainAddR + k);
+						gl = SelectGreater(sl, gl, Min(gl + sl * att, sl), gl + rel * (sl - gl));
+						gr = SelectGreater(sr, gr, Min(gr + sr * att, sr), gr + rel * (sr - gr));
+
+						V dl = V::Load(dlyL + k), dr = V::Load(dlyR + k);
+						gl = Max(Abs(dl) - one, gl);
+						gr = Max(Abs(dr) - one, gr);
+						gl.Store(b.gainAddL + k);
+						gr.Store(b.gainAddR + k);
+
+						V post = V::Load(b.thresholdMul + k);
+						V outMul = V::Load(b.outputMul + k);
+						V outl = Min(Max(dl / (one + gl), minusOne), one) * post * outMul;
+						V outr = Min(Max(dr / (one + gr), minusOne), one) * post * outMul;
+						outl.Store(sL + k);
+						outr.Store(sR + k);
+
+						Max(Max(gl, gr), V::Load(b.peakGain + k)).Store(b.peakGain + k);
+						Max(Max(Abs(outl), Abs(outr)), V::Load(b.peakOut + k)).Store(b.peakOut + k);
+					}
+				}
+			}
+
+			//Ȳ Lanes һ GetBatchKernel ѡҲʵñԽд
+			template<int Lanes>
+			LMK_FN void BatchChunk(BatchState<Lanes>& b, int n)
+			{
+				if constexpr (Lanes % LMK_VEC::Width == 0) BatchChunkBody(b, n);
+			}
+		}
+	}
+}
@@ -0,0 +1,329 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+
+#include "lmspsc.h"
+
+/*
+LMLoudnessMeter: ITU-R BS.1770-4 / EBU R128 ȱȨض1
+Ƶ߳ ProcessBlock ֻ K Ȩ˲ 100ms ۼӣÿ 100ms һֵ
+ Updatę̣߳Ⱦʱͬһ̣߳ȡ飬㣺
+	M   momentary   400ms 
+	S   short-term  3s 
+	I   integrated  400ms ſؿ飨75%ص-70 LUFS  + -10 LU 
+	LRA loudness range (EBU Tech 3342)3s 飬-70 LUFS  + -20 LU ţ10%~95% λ
+I  LRA  0.01 LU һֱͼۼƣÿͣÿθµĿͽĿ޹أ
+ڸмʱ㣬Ų 0.01 LUһĿҲȥ
+	I ͰſؿȷĽ < 0.1 LUʵԼ 0.015 LU
+	LRA λȡģͬʱ;ȷֵһڣŸöźܶʱ 10% λŲ
+	 Tech 3342  1 LU ڣʵԼ 0.4 LUǼٿУ
+Щ Source/tests/lmloudness.cpplmlimiter_loudnessTech 3341/3342 ĺϳźţ
+*/
+
+namespace LMLoudnessNamespace
+{
+	inline float EnergyToLUFS(double energy)
+	{
+		if (energy <= 0.0) return -INFINITY;
+		return (float)(-0.691 + 10.0 * log10(energy));
+	}
+
+	struct Biquad
+	{
+		double b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+		double z1 = 0, z2 = 0;
+
+		float ProcessSample(float x)
+		{
+			double y = b0 * x + z1;
+			z1 = b1 * x - a1 * y + z2;
+			z2 = b2 * x - a2 * y;
+			return (float)y;
+		}
+		void Reset()
+		{
+			z1 = z2 = 0;
+		}
+	};
+
+	class GateHistogram
+	{
+	public:
+		static constexpr int MinLUFS = -70;//
+		static constexpr int MaxLUFS = 10;
+		static constexpr int BinsPerLU = 100;
+		static constexpr int NumBins = (MaxLUFS - MinLUFS) * BinsPerLU;
+
+	private:
+		uint32_t counts[NumBins];
+		double energies[NumBins];
+		uint64_t totalCount = 0;
+		double totalEnergy = 0;
+
+		static int BinIndex(float lufs)
+		{
+			int b = (int)floorf((lufs - MinLUFS) * BinsPerLU);
+			return b < 0 ? 0 : (b >= NumBins ? NumBins - 1 : b);
+		}
+
+		//ϵһӣûݷ -1
+		int FirstGatedBin(float relativeGateLU) const
+		{
+			if (totalCount == 0) return -1;
+			float gate = EnergyToLUFS(totalEnergy / totalCount) + relativeGateLU;
+			return gate < MinLUFS ? 0 : BinIndex(gate);
+		}
+
+	public:
+		GateHistogram()
+		{
+			Clear();
+		}
+		void Clear()
+		{
+			memset(counts, 0, sizeof(counts));
+			memset(energies, 0, sizeof(energies));
+			totalCount = 0;
+			totalEnergy = 0;
+		}
+		static float BinLoudness(int b)
+		{
+			return MinLUFS + (b + 0.5f) / BinsPerLU;
+		}
+
+		void Add(double energy)
+		{
+			float lufs = EnergyToLUFS(energy);
+			if (!(lufs >= MinLUFS)) return;//
+			int b = BinIndex(lufs);
+			counts[b]++;
+			energies[b] += energy;
+			totalCount++;
+			totalEnergy += energy;
+		}
+
+		//ſغƽȣintegrated loudness
+		float GatedLoudness(float relativeGateLU) const
+		{
+			int first = FirstGatedBin(relativeGateLU);
+			if (first < 0) return -INFINITY;
+			uint64_t n = 0;
+			double e = 0;
+			for (int b = first; b < NumBins; ++b)
+			{
+				n += counts[b];
+				e += energies[b];
+			}
+			return n ? EnergyToLUFS(e / n) : -INFINITY;
+		}
+
+		//ſغ lowPercent  highPercent λĲloudness range
+		float GatedRange(float relativeGateLU, float lowPercent, float highPercent) const
+		{
+			int first = FirstGatedBin(relativeGateLU);
+			if (first < 0) return 0.0f;
+			uint64_t n = 0;
+			for (int b = first; b < NumBins; ++b) n += counts[b];
+			if (n == 0) return 0.0f;
+
+			uint64_t lowRank = (uint64_t)((n - 1) * lowPercent / 100.0f);
+			uint64_t highRank = (uint64_t)((n - 1) * highPercent / 100.0f);
+			int lowBin = -1, highBin = -1;
+			uint64_t seen = 0;
+			for (int b = first; b < NumBins && highBin < 0; ++b)
+			{
+				seen += counts[b];
+				if (lowBin < 0 && seen > lowRank) lowBin = b;
+				if (seen > highRank) highBin = b;
+			}
+			return BinLoudness(highBin) - BinLoudness(lowBin);
+		}
+	};
+}
+
+class LMLoudnessMeter
+{
+public:
+	struct Values
+	{
+		float momentary, shortTerm, integrated, range;//LUFS / LUûʱ -infrange  0
+		float maxMomentary, maxShortTerm;
+	};
+
+private:
+	static constexpr int MomentaryBlocks = 4;//400ms
+	static constexpr int ShortTermBlocks = 30;//3s
+
+	//Ƶ߳
+	LMLoudnessNamespace::Biquad preL, preR;//߼
+	LMLoudnessNamespace::Biquad rlbL, rlbR;//ͨ
+	double blockSum = 0;
+	int blockCounter = 0;
+	int blockSamples = 4800;
+	LMSpscRing<float, 4096> blocks;//100ms һͣ 400 Żᶪ
+
+	//
+	float recent[ShortTermBlocks];
+	int recentCount = 0, recentPos = 0;
+	LMLoudnessNamespace::GateHistogram momentaryHistogram, shortTermHistogram;
+	float maxMomentary = -INFINITY, maxShortTerm = -INFINITY;
+	std::atomic<bool> resetRequested{ false };
+
+	std::atomic<float> momentaryLUFS{ -INFINITY }, shortTermLUFS{ -INFINITY };
+	std::atomic<float> integratedLUFS{ -INFINITY }, rangeLU{ 0.0f };
+	std::atomic<float> maxMomentaryLUFS{ -INFINITY }, maxShortTermLUFS{ -INFINITY };
+
+	double RecentMean(int numBlocks) const
+	{
+		double sum = 0;
+		int pos = recentPos;
+		for (int i = 0; i < numBlocks; ++i)
+		{
+			pos = pos == 0 ? ShortTermBlocks - 1 : pos - 1;
+			sum += recent[pos];
+		}
+		return sum / numBlocks;
+	}
+
+	void ClearConsumer()
+	{
+		recentCount = recentPos = 0;
+		momentaryHistogram.Clear();
+		shortTermHistogram.Clear();
+		maxMomentary = maxShortTerm = -INFINITY;
+		momentaryLUFS.store(-INFINITY);
+		shortTermLUFS.store(-INFINITY);
+		integratedLUFS.store(-INFINITY);
+		rangeLU.store(0.0f);
+		maxMomentaryLUFS.store(-INFINITY);
+		maxShortTermLUFS.store(-INFINITY);
+	}
+
+public:
+	LMLoudnessMeter()
+	{
+		SetSampleRate(48000.0f);
+	}
+
+	//Ҫ ProcessBlock / Update ͬʱ
+	void SetSampleRate(float sampleRate)
+	{
+		//BS.1770 ˲˫Ա任
+		double K = tan(M_PI * 1681.974450955533 / sampleRate);
+		double Q = 0.7071752369554196;
+		double Vh = pow(10.0, 3.999843853973347 / 20.0);
+		double Vb = pow(Vh, 0.4996667741545416);
+		double a0 = 1.0 + K / Q + K * K;
+		preL.b0 = (Vh + Vb * K / Q + K * K) / a0;
+		preL.b1 = 2.0 * (K * K - Vh) / a0;
+		preL.b2 = (Vh - Vb * K / Q + K * K) / a0;
+		preL.a1 = 2.0 * (K * K - 1.0) / a0;
+		preL.a2 = (1.0 - K / Q + K * K) / a0;
+
+		K = tan(M_PI * 38.13547087602444 / sampleRate);
+		Q = 0.5003270373238773;
+		a0 = 1.0 + K / Q + K * K;
+		rlbL.b0 = 1.0;
+		rlbL.b1 = -2.0;
+		rlbL.b2 = 1.0;
+		rlbL.a1 = 2.0 * (K * K - 1.0) / a0;
+		rlbL.a2 = (1.0 - K / Q + K * K) / a0;
+
+		preR = preL;
+		rlbR = rlbL;
+		blockSamples = (int)(sampleRate / 10.0f + 0.5f);
+		if (blockSamples < 1) blockSamples = 1;
+		Reset();
+	}
+
+	//Ҫ ProcessBlock / Update ͬʱ
+	void Reset()
+	{
+		preL.Reset();
+		preR.Reset();
+		rlbL.Reset();
+		rlbR.Reset();
+		blockSum = 0;
+		blockCounter = 0;
+		blocks.Drain();
+		resetRequested.store(false);
+		ClearConsumer();
+	}
+
+	//κ̶߳Եãһ Update ʱ I/LRA/ֵ¿ʼ
+	void RequestReset()
+	{
+		resetRequested.store(true);
+	}
+
+	//Ƶ߳
+	void ProcessBlock(const float* inL, const float* inR, int numSamples)
+	{
+		for (int i = 0; i < numSamples; ++i)
+		{
+			float l = rlbL.ProcessSample(preL.ProcessSample(inL[i]));
+			float r = rlbR.ProcessSample(preR.ProcessSample(inR[i]));
+			blockSum += l * l + r * r;
+			if (++blockCounter >= blockSamples)
+			{
+				blocks.Push((float)(blockSum / blockSamples));
+				blockSum = 0;
+				blockCounter = 0;
+			}
+		}
+	}
+
+	//ߣȡµ 100ms 飬ж
+	void Update()
+	{
+		if (resetRequested.exchange(false)) ClearConsumer();
+
+		float energies[256];
+		int n = 0;
+		bool changed = false;
+		while ((n = blocks.Pop(energies, 256)) > 0)
+		{
+			changed = true;
+			for (int i = 0; i < n; ++i)
+			{
+				recent[recentPos] = energies[i];
+				recentPos = recentPos + 1 == ShortTermBlocks ? 0 : recentPos + 1;
+				if (recentCount < ShortTermBlocks) recentCount++;
+
+				if (recentCount >= MomentaryBlocks)
+				{
+					double e = RecentMean(MomentaryBlocks);
+					momentaryHistogram.Add(e);
+					float m = LMLoudnessNamespace::EnergyToLUFS(e);
+					momentaryLUFS.store(m);
+					if (m > maxMomentary) maxMomentary = m;
+				}
+				if (recentCount >= ShortTermBlocks)
+				{
+					double e = RecentMean(ShortTermBlocks);
+					shortTermHistogram.Add(e);
+					float s = LMLoudnessNamespace::EnergyToLUFS(e);
+					shortTermLUFS.store(s);
+					if (s > maxShortTerm) maxShortTerm = s;
+				}
+			}
+		}
+		if (!changed) return;
+
+		integratedLUFS.store(momentaryHistogram.GatedLoudness(-10.0f));
+		rangeLU.store(shortTermHistogram.GatedRange(-20.0f, 10.0f, 95.0f));
+		maxMomentaryLUFS.store(maxMomentary);
+		maxShortTermLUFS.store(maxShortTerm);
+	}
+
+	//κ߳
+	Values GetValues() const
+	{
+		return { momentaryLUFS.load(), shortTermLUFS.load(), integratedLUFS.load(), rangeLU.load(),
+			maxMomentaryLUFS.load(), maxShortTermLUFS.load() };
+	}
+};
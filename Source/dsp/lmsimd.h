@@ -0,0 +1,125 @@
+#pragma once
+
+#include <math.h>
+
+/*
+lmsimd: /鴦ںõһܱװ
+scalar / SSE2 / AVX2 / AVX-512 һռ䣨 1 / 4 / 8 / 16ͬʱͬһƣ
+һ lmcpu.h ʱ cpuid  Xeon  AVX-512 Ļ϶ϸ
+GCC/Clang  target ԵЩָMSVC ãڽֱӿã
+ǵĺҲҪͬԣ lmkernels.h
+Load/Store Ҫ루Ļ֤룩
+
+Max(a, b) / Min(a, b) / SelectGreater ͱ a > b ? a : b ȫһ£
+ں˺ LMLimiter ıͬ
+*/
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define LMSIMD_X86 1
+#endif
+
+#if LMSIMD_X86 && (defined(__GNUC__) || defined(__clang__))
+#define LMSIMD_TARGET(isa) __attribute__((target(isa)))
+#else
+#define LMSIMD_TARGET(isa)
+#endif
+#define LMSIMD_SSE2_FN LMSIMD_TARGET("sse2")
+#define LMSIMD_AVX2_FN LMSIMD_TARGET("avx2")
+#define LMSIMD_AVX512_FN LMSIMD_TARGET("avx512f")
+
+namespace LMLimiterNamespace
+{
+	namespace simd
+	{
+		namespace scalar
+		{
+			struct Vec
+			{
+				static constexpr int Width = 1;
+				float v;
+				static Vec Load(const float* p) { return { *p }; }
+				static Vec Set(float x) { return { x }; }
+				void Store(float* p) const { *p = v; }
+			};
+			inline Vec operator+(Vec a, Vec b) { return { a.v + b.v }; }
+			inline Vec operator-(Vec a, Vec b) { return { a.v - b.v }; }
+			inline Vec operator*(Vec a, Vec b) { return { a.v * b.v }; }
+			inline Vec operator/(Vec a, Vec b) { return { a.v / b.v }; }
+			inline Vec Max(Vec a, Vec b) { return { a.v > b.v ? a.v : b.v }; }
+			inline Vec Min(Vec a, Vec b) { return { a.v < b.v ? a.v : b.v }; }
+			inline Vec Abs(Vec a) { return { fabsf(a.v) }; }
+			inline Vec SelectGreater(Vec a, Vec b, Vec x, Vec y) { return { a.v > b.v ? x.v : y.v }; }
+		}
+
+#if LMSIMD_X86
+		namespace sse2
+		{
+			struct Vec
+			{
+				static constexpr int Width = 4;
+				__m128 v;
+				LMSIMD_SSE2_FN static Vec Load(const float* p) { return { _mm_loadu_ps(p) }; }
+				LMSIMD_SSE2_FN static Vec Set(float x) { return { _mm_set1_ps(x) }; }
+				LMSIMD_SSE2_FN void Store(float* p) const { _mm_storeu_ps(p, v); }
+			};
+			LMSIMD_SSE2_FN inline Vec operator+(Vec a, Vec b) { return { _mm_add_ps(a.v, b.v) }; }
+			LMSIMD_SSE2_FN inline Vec operator-(Vec a, Vec b) { return { _mm_sub_ps(a.v, b.v) }; }
+			LMSIMD_SSE2_FN inline Vec operator*(Vec a, Vec b) { return { _mm_mul_ps(a.v, b.v) }; }
+			LMSIMD_SSE2_FN inline Vec operator/(Vec a, Vec b) { return { _mm_div_ps(a.v, b.v) }; }
+			LMSIMD_SSE2_FN inline Vec Max(Vec a, Vec b) { return { _mm_max_ps(a.v, b.v) }; }
+			LMSIMD_SSE2_FN inline Vec Min(Vec a, Vec b) { return { _mm_min_ps(a.v, b.v) }; }
+			LMSIMD_SSE2_FN inline Vec Abs(Vec a) { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+			LMSIMD_SSE2_FN inline Vec SelectGreater(Vec a, Vec b, Vec x, Vec y)
+			{
+				__m128 m = _mm_cmpgt_ps(a.v, b.v);
+				return { _mm_or_ps(_mm_and_ps(m, x.v), _mm_andnot_ps(m, y.v)) };
+			}
+		}
+
+		namespace avx2
+		{
+			struct Vec
+			{
+				static constexpr int Width = 8;
+				__m256 v;
+				LMSIMD_AVX2_FN static Vec Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+				LMSIMD_AVX2_FN static Vec Set(float x) { return { _mm256_set1_ps(x) }; }
+				LMSIMD_AVX2_FN void Store(float* p) const { _mm256_storeu_ps(p, v); }
+			};
+			LMSIMD_AVX2_FN inline Vec operator+(Vec a, Vec b) { return { _mm256_add_ps(a.v, b.v) }; }
+			LMSIMD_AVX2_FN inline Vec operator-(Vec a, Vec b) { return { _mm256_sub_ps(a.v, b.v) }; }
+			LMSIMD_AVX2_FN inline Vec operator*(Vec a, Vec b) { return { _mm256_mul_ps(a.v, b.v) }; }
+			LMSIMD_AVX2_FN inline Vec operator/(Vec a, Vec b) { return { _mm256_div_ps(a.v, b.v) }; }
+			LMSIMD_AVX2_FN inline Vec Max(Vec a, Vec b) { return { _mm256_max_ps(a.v, b.v) }; }
+			LMSIMD_AVX2_FN inline Vec Min(Vec a, Vec b) { return { _mm256_min_ps(a.v, b.v) }; }
+			LMSIMD_AVX2_FN inline Vec Abs(Vec a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+			LMSIMD_AVX2_FN inline Vec SelectGreater(Vec a, Vec b, Vec x, Vec y) { return { _mm256_blendv_ps(y.v, x.v, _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)) }; }
+		}
+
+		namespace avx512
+		{
+			struct Vec
+			{
+				static constexpr int Width = 16;
+				__m512 v;
+				LMSIMD_AVX512_FN static Vec Load(const float* p) { return { _mm512_loadu_ps(p) }; }
+				LMSIMD_AVX512_FN static Vec Set(float x) { return { _mm512_set1_ps(x) }; }
+				LMSIMD_AVX512_FN void Store(float* p) const { _mm512_storeu_ps(p, v); }
+			};
+			//avx512f ͬʱ FMAGCC  _mm512_mul_ps  _mm512_add_ps ϳһ fmaһ룩
+			//ͱָ ulp _round İ汾ڽᱻϲ
+			// _round / max / min  _mm512_undefined_ps() ԴGCC -Wall ± '__Y' may be used uninitialized
+			//һȫ 1  maskz 汾һԴȷ 0
+			LMSIMD_AVX512_FN inline Vec operator+(Vec a, Vec b) { return { _mm512_maskz_add_round_ps((__mmask16)0xFFFF, a.v, b.v, _MM_FROUND_CUR_DIRECTION) }; }
+			LMSIMD_AVX512_FN inline Vec operator-(Vec a, Vec b) { return { _mm512_maskz_sub_round_ps((__mmask16)0xFFFF, a.v, b.v, _MM_FROUND_CUR_DIRECTION) }; }
+			LMSIMD_AVX512_FN inline Vec operator*(Vec a, Vec b) { return { _mm512_maskz_mul_round_ps((__mmask16)0xFFFF, a.v, b.v, _MM_FROUND_CUR_DIRECTION) }; }
+			LMSIMD_AVX512_FN inline Vec operator/(Vec a, Vec b) { return { _mm512_div_ps(a.v, b.v) }; }
+			LMSIMD_AVX512_FN inline Vec Max(Vec a, Vec b) { return { _mm512_maskz_max_ps((__mmask16)0xFFFF, a.v, b.v) }; }
+			LMSIMD_AVX512_FN inline Vec Min(Vec a, Vec b) { return { _mm512_maskz_min_ps((__mmask16)0xFFFF, a.v, b.v) }; }
+			LMSIMD_AVX512_FN inline Vec Abs(Vec a) { return { _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(0x7fffffff))) }; }
+			LMSIMD_AVX512_FN inline Vec SelectGreater(Vec a, Vec b, Vec x, Vec y) { return { _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a.v, b.v, _CMP_GT_OQ), y.v, x.v) }; }
+		}
+#endif
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+/*
+LMSpscRing: ߵߵλ
+һƵ̣߳˾Ͷݣ UI ̨߳
+*/
+
+template<typename T, int Capacity>
+class LMSpscRing
+{
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+private:
+	T items[Capacity];
+	alignas(64) std::atomic<uint32_t> writeIndex{ 0 };
+	alignas(64) std::atomic<uint32_t> readIndex{ 0 };
+
+public:
+	//
+	bool Push(const T& item)
+	{
+		uint32_t w = writeIndex.load(std::memory_order_relaxed);
+		if (w - readIndex.load(std::memory_order_acquire) >= (uint32_t)Capacity) return false;
+		items[w & (Capacity - 1)] = item;
+		writeIndex.store(w + 1, std::memory_order_release);
+		return true;
+	}
+
+	//ߣȡĸ
+	int Pop(T* dest, int maxItems)
+	{
+		uint32_t r = readIndex.load(std::memory_order_relaxed);
+		uint32_t available = writeIndex.load(std::memory_order_acquire) - r;
+		int n = available < (uint32_t)maxItems ? (int)available : maxItems;
+		for (int i = 0; i < n; ++i) dest[i] = items[(r + i) & (Capacity - 1)];
+		readIndex.store(r + n, std::memory_order_release);
+		return n;
+	}
+
+	//߶ѹľ
+	void Drain()
+	{
+		readIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+	}
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+/*
+lmtrace: ѡķֶμʱ Chrome trace JSONchrome://tracing  ui.perfetto.dev 򿪣
+
+ʱ LMLIMITER_TRACE=1 Ч LMTRACE_SCOPE չΪգûκο
+ÿ̵߳һμ¼ʱȡһԤȷõĻλ壬֮¼ֻдʱ䲻
+д󸲸ɵ¼
+*/
+
+#ifndef LMLIMITER_TRACE
+#define LMLIMITER_TRACE 0
+#endif
+
+#if LMLIMITER_TRACE
+
+#include <atomic>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+
+#ifndef LMLIMITER_TRACE_EVENTS_PER_THREAD
+#define LMLIMITER_TRACE_EVENTS_PER_THREAD 16384
+#endif
+#ifndef LMLIMITER_TRACE_MAX_THREADS
+#define LMLIMITER_TRACE_MAX_THREADS 16
+#endif
+
+namespace LMTrace
+{
+	struct Event
+	{
+		const char* name;//ַ
+		int64_t beginNs;
+		int64_t endNs;
+	};
+
+	struct ThreadRing
+	{
+		static constexpr uint32_t Capacity = LMLIMITER_TRACE_EVENTS_PER_THREAD;
+		Event events[Capacity];
+		std::atomic<uint32_t> count{ 0 };//һдٸ±Capacityȡģ
+
+		void Push(const char* name, int64_t beginNs, int64_t endNs)
+		{
+			uint32_t n = count.load(std::memory_order_relaxed);
+			events[n % Capacity] = { name, beginNs, endNs };
+			count.store(n + 1, std::memory_order_release);
+		}
+	};
+
+	struct Registry
+	{
+		ThreadRing rings[LMLIMITER_TRACE_MAX_THREADS];
+		std::atomic<int> numRings{ 0 };
+	};
+
+	inline Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	inline int64_t NowNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	//߳ LMLIMITER_TRACE_MAX_THREADS Ĳֲ¼
+	inline ThreadRing* GetThreadRing()
+	{
+		thread_local ThreadRing* ring = nullptr;
+		thread_local bool claimed = false;
+		if (!claimed)
+		{
+			claimed = true;
+			int index = GetRegistry().numRings.fetch_add(1);
+			if (index < LMLIMITER_TRACE_MAX_THREADS) ring = &GetRegistry().rings[index];
+		}
+		return ring;
+	}
+
+	class Scope
+	{
+	private:
+		const char* name;
+		int64_t beginNs;
+	public:
+		explicit Scope(const char* name) : name(name), beginNs(NowNs()) {}
+		~Scope()
+		{
+			if (ThreadRing* ring = GetThreadRing()) ring->Push(name, beginNs, NowNs());
+		}
+	};
+
+	//дǰ̻߳¼Ƶ̻߳ܵʱã
+	//ڱǵһ¼ܲӰ
+	inline bool WriteChromeJson(const char* path)
+	{
+		FILE* f = fopen(path, "w");
+		if (!f) return false;
+
+		Registry& reg = GetRegistry();
+		int numRings = reg.numRings.load();
+		if (numRings > LMLIMITER_TRACE_MAX_THREADS) numRings = LMLIMITER_TRACE_MAX_THREADS;
+
+		fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+		bool first = true;
+		for (int t = 0; t < numRings; ++t)
+		{
+			const ThreadRing& ring = reg.rings[t];
+			uint32_t n = ring.count.load(std::memory_order_acquire);
+			uint32_t begin = n > ThreadRing::Capacity ? n - ThreadRing::Capacity : 0;
+			for (uint32_t i = begin; i < n; ++i)
+			{
+				const Event& e = ring.events[i % ThreadRing::Capacity];
+				if (!e.name) continue;
+				fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+					first ? "" : ",\n", e.name, t + 1, e.beginNs / 1000.0, (e.endNs - e.beginNs) / 1000.0);
+				first = false;
+			}
+		}
+		fprintf(f, "\n]}\n");
+		fclose(f);
+		return true;
+	}
+}
+
+#define LMTRACE_CONCAT_(a, b) a##b
+#define LMTRACE_CONCAT(a, b) LMTRACE_CONCAT_(a, b)
+#define LMTRACE_SCOPE(name) LMTrace::Scope LMTRACE_CONCAT(lmTraceScope, __LINE__)(name)
+
+#else
+
+#define LMTRACE_SCOPE(name)
+
+#endif
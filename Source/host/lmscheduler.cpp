@@ -0,0 +1,249 @@
+#include "lmscheduler.h"
+
+#include <algorithm>
+#include <chrono>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace
+{
+	constexpr int SpinRounds = 64;//ûʱô˯
+
+	bool EarlierDeadline(int64_t a, int64_t b) { return a < b; }
+}
+
+//==============================================================================
+bool LMScheduler::Worker::Push(const Job& job)
+{
+	if (size >= (int)heap.size()) return false;
+	int i = size++;
+	while (i > 0)
+	{
+		int parent = (i - 1) / 2;
+		if (!EarlierDeadline(job.deadlineNs, heap[parent].deadlineNs)) break;
+		heap[i] = heap[parent];
+		i = parent;
+	}
+	heap[i] = job;
+	return true;
+}
+
+bool LMScheduler::Worker::Pop(Job& job)
+{
+	if (size == 0) return false;
+	job = heap[0];
+	Job last = heap[--size];
+	int i = 0;
+	for (;;)
+	{
+		int child = i * 2 + 1;
+		if (child >= size) break;
+		if (child + 1 < size && EarlierDeadline(heap[child + 1].deadlineNs, heap[child].deadlineNs)) ++child;
+		if (!EarlierDeadline(heap[child].deadlineNs, last.deadlineNs)) break;
+		heap[i] = heap[child];
+		i = child;
+	}
+	heap[i] = last;
+	return true;
+}
+
+//==============================================================================
+LMScheduler::LMScheduler(const Options& options)
+{
+	int n = options.numWorkers > 0 ? options.numWorkers : (int)std::thread::hardware_concurrency();
+	if (n < 1) n = 1;
+	int capacity = options.queueCapacity > 0 ? options.queueCapacity : 1;
+
+	for (int i = 0; i < n; ++i)
+	{
+		workers.push_back(std::make_unique<Worker>());
+		workers.back()->heap.resize(capacity);
+	}
+	for (int i = 0; i < n; ++i)
+	{
+		workers[i]->thread = std::thread(&LMScheduler::WorkerLoop, this, i);
+		if (options.pinToCores) PinToCore(workers[i]->thread, options.firstCore + i);
+	}
+}
+
+LMScheduler::~LMScheduler()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		running.store(false);
+	}
+	wakeCv.notify_all();
+	for (auto& w : workers)
+		if (w->thread.joinable()) w->thread.join();
+}
+
+int64_t LMScheduler::NowNs()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LMScheduler::PinToCore(std::thread& thread, int core)
+{
+#if defined(__linux__)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(core % CPU_SETSIZE, &set);
+	pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+#elif defined(_WIN32)
+	SetThreadAffinityMask((HANDLE)thread.native_handle(), (DWORD_PTR)1 << (core % (sizeof(DWORD_PTR) * 8)));
+#else
+	(void)thread;
+	(void)core;
+#endif
+}
+
+bool LMScheduler::Submit(JobFunc func, void* context, int64_t deadlineNs, int preferredWorker)
+{
+	const int n = (int)workers.size();
+	int index = preferredWorker >= 0 ? preferredWorker % n : nextWorker.fetch_add(1, std::memory_order_relaxed) % n;
+	if (index < 0) index += n;
+
+	Job job{ func, context, deadlineNs, NowNs() };
+	inFlight.fetch_add(1, std::memory_order_acq_rel);
+	//ȼӼٷŽѣһŽȥͿܱ߳ȡ߲ӵĻ queued ݱɸ˯ŵ߳̾Ѳ
+	queued.fetch_add(1);
+
+	bool pushed = false;
+	for (int tries = 0; tries < n && !pushed; ++tries)//ѡ˾ͷŵһ
+	{
+		Worker& w = *workers[(index + tries) % n];
+		w.Lock();
+		pushed = w.Push(job);
+		w.Unlock();
+	}
+	if (!pushed)
+	{
+		queued.fetch_sub(1);
+		inFlight.fetch_sub(1, std::memory_order_acq_rel);
+		return false;
+	}
+
+	if (sleepers.load() > 0)
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		wakeCv.notify_one();
+	}
+	return true;
+}
+
+void LMScheduler::WaitIdle()
+{
+	std::unique_lock<std::mutex> lock(sleepMutex);
+	idleCv.wait(lock, [this] { return inFlight.load(std::memory_order_acquire) == 0; });
+}
+
+bool LMScheduler::FindJob(int index, Job& job)
+{
+	Worker& self = *workers[index];
+	self.Lock();
+	bool found = self.Pop(job);
+	self.Unlock();
+	if (found)
+	{
+		queued.fetch_sub(1);
+		return true;
+	}
+
+	//͵һ߳̿ʼһȦõ͵òͻһ
+	const int n = (int)workers.size();
+	for (int i = 1; i < n; ++i)
+	{
+		Worker& victim = *workers[(index + i) % n];
+		if (!victim.TryLock()) continue;
+		found = victim.Pop(job);
+		victim.Unlock();
+		if (found)
+		{
+			queued.fetch_sub(1);
+			self.steals.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+	return false;
+}
+
+void LMScheduler::RunJob(Worker& self, const Job& job)
+{
+	job.func(job.context);
+
+	int64_t done = NowNs();
+	self.latency.Record((uint64_t)(done > job.submitNs ? done - job.submitNs : 0));
+	if (done > job.deadlineNs) self.misses.fetch_add(1, std::memory_order_relaxed);
+
+	if (inFlight.fetch_sub(1, std::memory_order_acq_rel) == 1)
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		idleCv.notify_all();
+	}
+}
+
+void LMScheduler::WorkerLoop(int index)
+{
+	Worker& self = *workers[index];
+	Job job;
+	int idleRounds = 0;
+
+	while (running.load(std::memory_order_acquire))
+	{
+		if (FindJob(index, job))
+		{
+			RunJob(self, job);
+			idleRounds = 0;
+			continue;
+		}
+
+		if (++idleRounds < SpinRounds)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		//ûˣ˯Ͷݻ
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		sleepers.fetch_add(1);
+		wakeCv.wait_for(lock, std::chrono::milliseconds(10), [this] {
+			return !running.load() || queued.load() > 0;
+		});
+		sleepers.fetch_sub(1);
+		idleRounds = 0;
+	}
+}
+
+LMScheduler::Stats LMScheduler::GetStats() const
+{
+	Stats stats;
+	LMHistogram merged;
+	for (auto& w : workers)
+	{
+		merged.Merge(w->latency);
+		stats.deadlineMisses += w->misses.load(std::memory_order_relaxed);
+		stats.steals += w->steals.load(std::memory_order_relaxed);
+	}
+	stats.completed = merged.GetCount();
+	stats.p50Ns = merged.GetPercentile(0.5);
+	stats.p99Ns = merged.GetPercentile(0.99);
+	stats.p999Ns = merged.GetPercentile(0.999);
+	stats.maxNs = merged.GetMax();
+	return stats;
+}
+
+void LMScheduler::ResetStats()
+{
+	for (auto& w : workers)
+	{
+		w->latency.Clear();
+		w->misses.store(0, std::memory_order_relaxed);
+		w->steals.store(0, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "../dsp/lmlimiter.h"
+#include "../dsp/lmhistogram.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+/*
+LMScheduler: һѴʵĿ鴦̯
+- ÿ߳һdeadlineѣEDFԼȡ絽ڵ
+- Լûʱȥ߳͵絽ڵwork stealingкŶĺ˻ѹ
+- ѡѹ̰߳󶨵̶ĺϣͬһ·ĬͶݵͬһ̣߳״̬ڸú˻
+- ¼ÿͶݵɵӳ٣ֱͼ p50/p99/p999  deadline miss 
+
+ڹʱһԷ䣬Submit/ִ·ϲٷڴ
+*/
+
+class LMScheduler
+{
+public:
+	using JobFunc = void(*)(void* context);
+
+	struct Options
+	{
+		int numWorkers = 0;			//0 = Ӳ߳
+		bool pinToCores = false;	//߳ i 󶨵 firstCore + i
+		int firstCore = 0;
+		int queueCapacity = 4096;	//ÿ̵߳
+	};
+
+	struct Stats
+	{
+		uint64_t completed = 0;
+		uint64_t deadlineMisses = 0;
+		uint64_t steals = 0;
+		uint64_t p50Ns = 0, p99Ns = 0, p999Ns = 0, maxNs = 0;//Ͷݵ
+	};
+
+	explicit LMScheduler(const Options& options);
+	LMScheduler() : LMScheduler(Options()) {}
+	~LMScheduler();
+
+	//deadlineNs  NowNs() ʱϵľʱ䣻preferredWorker < 0 ʱѯ
+	//ʱ false
+	bool Submit(JobFunc func, void* context, int64_t deadlineNs, int preferredWorker = -1);
+	//ȵͶݵִ
+	void WaitIdle();
+
+	int GetNumWorkers() const { return (int)workers.size(); }
+	Stats GetStats() const;
+	void ResetStats();
+
+	static int64_t NowNs();
+
+private:
+	struct Job
+	{
+		JobFunc func;
+		void* context;
+		int64_t deadlineNs;
+		int64_t submitNs;
+	};
+
+	struct alignas(64) Worker
+	{
+		std::atomic_flag lock = ATOMIC_FLAG_INIT;
+		std::vector<Job> heap;// deadline Сѣ̶
+		int size = 0;
+		LMHistogram latency;
+		std::atomic<uint64_t> misses{ 0 };
+		std::atomic<uint64_t> steals{ 0 };
+		std::thread thread;
+
+		void Lock() { while (lock.test_and_set(std::memory_order_acquire)) std::this_thread::yield(); }
+		bool TryLock() { return !lock.test_and_set(std::memory_order_acquire); }
+		void Unlock() { lock.clear(std::memory_order_release); }
+		bool Push(const Job& job);
+		bool Pop(Job& job);
+	};
+
+	std::vector<std::unique_ptr<Worker>> workers;
+	std::atomic<bool> running{ true };
+	std::atomic<int64_t> inFlight{ 0 };//Ͷݡδ
+	std::atomic<int64_t> queued{ 0 };//ڶûȡ
+	std::atomic<int> nextWorker{ 0 };
+	std::atomic<int> sleepers{ 0 };
+	std::mutex sleepMutex;
+	std::condition_variable wakeCv;
+	std::condition_variable idleCv;
+
+	void WorkerLoop(int index);
+	bool FindJob(int index, Job& job);
+	void RunJob(Worker& self, const Job& job);
+	static void PinToCore(std::thread& thread, int core);
+};
+
+/*
+LMLimiterStreamJob: һ·һ飬ֱΪ Submit  context
+	job.limiter->ProcessBlock(inL, inR, outL, outR, numSamples)
+÷ǰֻЧͬһ limiter ҪͬʱͶ
+*/
+struct LMLimiterStreamJob
+{
+	LMLimiter* limiter = nullptr;
+	const float* inL = nullptr;
+	const float* inR = nullptr;
+	float* outL = nullptr;
+	float* outR = nullptr;
+	int numSamples = 0;
+
+	static void Run(void* context)
+	{
+		LMLimiterStreamJob* job = static_cast<LMLimiterStreamJob*>(context);
+		job->limiter->ProcessBlock(job->inL, job->inR, job->outL, job->outR, job->numSamples);
+	}
+};
@@ -0,0 +1,213 @@
+/*
+lmlimiter_fastmath: ˶ lmfastmath.h עд
+ float λģʽ Stride ȡһɨһ飨ʡʱ䣩 double  log2/exp2/pow ȣ
+	1. FastLog2 / FastExp2 / GainToDb / DbToGain ע
+	2. simd::scalar / sse2 / avx2 / avx512  Vec 汾ֵ֧ģ lane ͱ汾ȫͬ NaN ͳΧ룩
+	3. ߽磺FastExp2(0) = 1DbToGain(0) = 1FastExp2(NaN) = FastExp2(-126)ΧеϣFastLog2(0) ֵ
+κһ㷵 1
+*/
+
+#include "../dsp/lmfastmath.h"
+#include "../dsp/lmcpu.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+	using namespace LMLimiterNamespace;
+
+	//ȡβÿһλɨ
+	constexpr uint32_t Stride = 17;
+
+	//עд
+	constexpr double Log2MaxAbs = 4.2e-6;
+	constexpr double Exp2MaxRel = 2e-7;
+	constexpr double GainToDbMaxAbs = 6.5e-5;
+	constexpr double DbToGainMaxRel = 3.1e-6;
+
+	int failures = 0;
+
+	void Fail(const char* fmt, ...)
+	{
+		if (++failures > 40) return;
+		va_list args;
+		va_start(args, fmt);
+		printf("FAIL: ");
+		vprintf(fmt, args);
+		printf("\n");
+		va_end(args);
+	}
+
+	float FromBits(uint32_t bits)
+	{
+		float x;
+		memcpy(&x, &bits, 4);
+		return x;
+	}
+
+	bool SameBits(float a, float b)
+	{
+		return memcmp(&a, &b, 4) == 0;
+	}
+
+	//ɨ [lo, hi] ȫ floatͳֵλ
+	struct Sweep
+	{
+		double maxErr = 0;
+		float worst = 0;
+		void Add(float x, double err)
+		{
+			if (!(err <= maxErr)) { maxErr = err; worst = x; }
+		}
+	};
+
+	template<typename F>
+	void ForEachFloat(float lo, float hi, F f)
+	{
+		for (uint64_t bits = 0; bits < 0x100000000ull; bits += Stride)
+		{
+			float x = FromBits((uint32_t)bits);
+			if (x >= lo && x <= hi) f(x);
+		}
+		f(lo);
+		f(hi);
+	}
+
+	void Check(const char* what, const Sweep& s, double limit)
+	{
+		printf("%-10s max error %.3g (at %.9g), limit %.3g\n", what, s.maxErr, s.worst, limit);
+		if (!(s.maxErr <= limit)) Fail("%s: max error %.3g at %.9g exceeds %.3g", what, s.maxErr, s.worst, limit);
+	}
+
+	void CheckErrorBounds()
+	{
+		Sweep log2Err, gainToDbErr;
+		ForEachFloat(1.17549435e-38f, 3.40282347e+38f, [&](float x)
+		{
+			double ref = log2((double)x);
+			log2Err.Add(x, fabs(FastLog2(x) - ref));
+			gainToDbErr.Add(x, fabs(GainToDb(x) - 20.0 * log10((double)x)));
+		});
+		Check("FastLog2", log2Err, Log2MaxAbs);
+		Check("GainToDb", gainToDbErr, GainToDbMaxAbs);
+
+		Sweep exp2Err;
+		ForEachFloat(-126.0f, 126.0f, [&](float x)
+		{
+			double ref = exp2((double)x);
+			exp2Err.Add(x, fabs(FastExp2(x) - ref) / ref);
+		});
+		Check("FastExp2", exp2Err, Exp2MaxRel);
+
+		Sweep dbToGainErr;
+		ForEachFloat(-758.0f, 758.0f, [&](float x)
+		{
+			double ref = pow(10.0, x / 20.0);
+			dbToGainErr.Add(x, fabs(DbToGain(x) - ref) / ref);
+		});
+		Check("DbToGain", dbToGainErr, DbToGainMaxRel);
+	}
+
+	void CheckEdges()
+	{
+		const float nan = FromBits(0x7fc00000);
+		if (FastExp2(0.0f) != 1.0f) Fail("FastExp2(0) = %.9g", FastExp2(0.0f));
+		if (DbToGain(0.0f) != 1.0f) Fail("DbToGain(0) = %.9g", DbToGain(0.0f));
+		if (!SameBits(FastExp2(nan), FastExp2(-126.0f))) Fail("FastExp2(NaN) = %.9g", FastExp2(nan));
+		if (!SameBits(FastExp2(-1000.0f), FastExp2(-126.0f))) Fail("FastExp2(-1000) not clamped");
+		if (!SameBits(FastExp2(1000.0f), FastExp2(126.0f))) Fail("FastExp2(1000) not clamped");
+		if (!SameBits(FastExp2(-INFINITY), FastExp2(-126.0f))) Fail("FastExp2(-inf) not clamped");
+		if (!SameBits(FastExp2(INFINITY), FastExp2(126.0f))) Fail("FastExp2(inf) not clamped");
+		if (!isfinite(FastLog2(0.0f))) Fail("FastLog2(0) = %.9g", FastLog2(0.0f));
+		if (!isfinite(FastLog2(1e-45f))) Fail("FastLog2(denormal) = %.9g", FastLog2(1e-45f));
+	}
+
+	enum { FnLog2, FnExp2, FnGainToDb, FnDbToGain };
+
+	//ĳָ Vec 汾ĺҪͬ target ԣ lmsimd.h
+#define LMFASTMATH_TEST_ISA(NS, FN) \
+	struct NS##Fns \
+	{ \
+		using Vec = simd::NS::Vec; \
+		FN static void Apply(int fn, const float* in, float* out) \
+		{ \
+			Vec x = Vec::Load(in); \
+			Vec y = fn == FnLog2 ? simd::NS::FastLog2(x) : fn == FnExp2 ? simd::NS::FastExp2(x) \
+				: fn == FnGainToDb ? simd::NS::GainToDb(x) : simd::NS::DbToGain(x); \
+			y.Store(out); \
+		} \
+	};
+	LMFASTMATH_TEST_ISA(scalar, )
+#if LMSIMD_X86
+	LMFASTMATH_TEST_ISA(sse2, LMSIMD_SSE2_FN)
+	LMFASTMATH_TEST_ISA(avx2, LMSIMD_AVX2_FN)
+	LMFASTMATH_TEST_ISA(avx512, LMSIMD_AVX512_FN)
+#endif
+
+	//Vec 汾һ lane ͱλģʽ
+	template<typename Fns>
+	void CheckVecMatchesScalar(cpu::Isa isa)
+	{
+		constexpr int Width = Fns::Vec::Width;
+		float in[Width], out[Width];
+		int mismatches = 0;
+		auto compare = [&](int fn, const char* what, float (*scalarFn)(float))
+		{
+			Fns::Apply(fn, in, out);
+			for (int i = 0; i < Width; ++i)
+			{
+				const float expected = scalarFn(in[i]);
+				if (!SameBits(out[i], expected) && !(out[i] != out[i] && expected != expected))
+				{
+					if (++mismatches <= 10)
+						Fail("%s %s(%.9g) = %.9g, scalar %.9g", cpu::IsaName(isa), what, in[i], out[i], expected);
+				}
+			}
+		};
+		int filled = 0;
+		auto push = [&](float x)
+		{
+			in[filled++] = x;
+			if (filled < Width) return;
+			filled = 0;
+			compare(FnLog2, "FastLog2", FastLog2);
+			compare(FnExp2, "FastExp2", FastExp2);
+			compare(FnGainToDb, "GainToDb", GainToDb);
+			compare(FnDbToGain, "DbToGain", DbToGain);
+		};
+		for (uint64_t bits = 0; bits < 0x100000000ull; bits += Stride * 64)
+			push(FromBits((uint32_t)bits));
+		const float edges[] = { 0.0f, -0.0f, 1.0f, -126.0f, 126.0f, -1000.0f, 1000.0f,
+			INFINITY, -INFINITY, FromBits(0x7fc00000), FromBits(0xffc00000), 1e-45f };
+		for (float x : edges) push(x);
+		while (filled != 0) push(0.5f);
+		printf("%s Vec (%d lanes) vs scalar: %d mismatches\n", cpu::IsaName(isa), Width, mismatches);
+	}
+
+	//ֵ֧ÿָһ
+	void CheckAllIsas()
+	{
+		const cpu::Isa best = cpu::DetectIsa();
+		CheckVecMatchesScalar<scalarFns>(cpu::Isa::Scalar);
+#if LMSIMD_X86
+		if (best >= cpu::Isa::SSE2) CheckVecMatchesScalar<sse2Fns>(cpu::Isa::SSE2);
+		if (best >= cpu::Isa::AVX2) CheckVecMatchesScalar<avx2Fns>(cpu::Isa::AVX2);
+		if (best >= cpu::Isa::AVX512) CheckVecMatchesScalar<avx512Fns>(cpu::Isa::AVX512);
+#endif
+		(void)best;
+	}
+}
+
+int main()
+{
+	CheckErrorBounds();
+	CheckEdges();
+	CheckAllIsas();
+	if (failures) printf("%d failure(s)\n", failures);
+	else printf("all fast math checks passed\n");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,685 @@
+/*
+lmlimiter_golden: Żĸ汾ͶĲοʵ֣lmreference.hı LMLimiterԱ
+źɵģɨƵ⧷弤ֱԾֵҡ lookahead ͷ
+˵ attack/releaseƵúֵ͡治Ϊ 0ÿϴӡ ULP 
+飺
+	1. ÿ汾 threshold  output gainM/S ģʽС컨֮ͣ
+	2. LMLimiterӿ顢 dB 㡢ɻʱͲο RefTolerance ڣ컨壩
+	3. ָںˡͬ鳤C API  LMLimiter ںȫͬC API ԭͨԷش
+	4. ÿһ·Ͳο RefTolerance ڣָںͬ
+	5. ģʽƽattackʡ硢M/SӦrelease; lookaheadֻ컨
+	6. ĲѹźţĲѹӽ컨ź
+	7. ģʽ lookahead ر䣨ʱһֱڻ켶ڳ弤֮ǰͿʼѹ
+κһ㷵 1
+*/
+
+#include "../dsp/lmlimiter.h"
+#include "../dsp/lmlimiter_batch.h"
+#include "../capi/lmlimiter_c.h"
+#include "lmreference.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+	//컨壺ʵԼ 1e-6 dB 㡢ӿ˳򣩣һ
+	constexpr double RefTolerance = 1e-5;
+
+	struct Signal
+	{
+		const char* name;
+		std::vector<float> l, r;
+	};
+
+	struct Setting
+	{
+		const char* name;
+		float lookahead, attack, release, input, output, threshold;
+	};
+
+	const Setting Settings[] = {
+		{ "default",        5, 1, 10, 0, 0, 0 },
+		{ "no lookahead",   0, 1, 10, 6, 0, 0 },
+		{ "max lookahead", 20, 1, 10, 6, 0, 0 },
+		{ "slow attack",    5, 500, 10, 6, 0, 0 },
+		{ "fast release",   2, 0, 4, 12, 0, -6 },
+		{ "slow release",  10, 10, 500, 12, 0, -6 },
+		{ "hot input",      5, 1, 60, 30, -3, -12 },
+		{ "gain staging",   5, 1, 30, -6, 6, 3 },
+	};
+	constexpr int NumSettings = sizeof(Settings) / sizeof(Settings[0]);
+
+	struct Rng
+	{
+		uint32_t state = 1;
+		float Uniform(float lo, float hi)
+		{
+			state = state * 1664525u + 1013904223u;
+			return lo + (hi - lo) * (state >> 8) * (1.0f / 16777216.0f);
+		}
+	};
+
+	std::vector<Signal> MakeCorpus(double sampleRate)
+	{
+		const int n = (int)sampleRate;//1 
+		std::vector<Signal> corpus;
+		auto add = [&](const char* name, auto gen)
+		{
+			Signal s{ name, std::vector<float>(n), std::vector<float>(n) };
+			for (int i = 0; i < n; ++i) gen(i, i / sampleRate, s.l[i], s.r[i]);
+			corpus.push_back(std::move(s));
+		};
+		Rng rng;
+		add("sweep", [&](int, double t, float& l, float& r)
+		{
+			double ph = 2.0 * M_PI * (20.0 * t + 0.5 * (sampleRate * 0.4 - 20.0) * t * t);
+			l = (float)(1.4 * sin(ph));
+			r = (float)(0.9 * cos(ph));
+		});
+		add("noise", [&](int, double, float& l, float& r)
+		{
+			l = rng.Uniform(-1.6f, 1.6f);
+			r = rng.Uniform(-1.2f, 1.2f);
+		});
+		add("bursts", [&](int, double t, float& l, float& r)
+		{
+			float env = fmod(t, 0.25) < 0.03 ? 3.0f : 0.1f;
+			l = env * (float)sin(2.0 * M_PI * 110.0 * t);
+			r = env * (float)sin(2.0 * M_PI * 173.0 * t);
+		});
+		add("impulses", [&](int i, double, float& l, float& r)
+		{
+			l = i % 997 == 0 ? 4.0f : 0.0f;
+			r = i % 1499 == 0 ? -6.0f : 0.0f;
+		});
+		add("square", [&](int, double t, float& l, float& r)
+		{
+			l = fmod(t * 60.0, 1.0) < 0.5 ? 1.3f : -1.3f;
+			r = fmod(t * 41.0, 1.0) < 0.5 ? 0.7f : -2.0f;
+		});
+		add("dc step", [&](int i, double, float& l, float& r)
+		{
+			l = i < n / 3 ? 0.0f : (i < 2 * n / 3 ? 2.0f : -0.5f);
+			r = i < n / 2 ? -1.5f : 0.0f;
+		});
+		add("near ceiling", [&](int, double t, float& l, float& r)
+		{
+			l = (float)(1.0005 * sin(2.0 * M_PI * 997.0 * t));
+			r = (float)(0.9995 * sin(2.0 * M_PI * 1003.0 * t));
+		});
+		add("silence", [&](int, double, float& l, float& r)
+		{
+			l = r = 0.0f;
+		});
+		return corpus;
+	}
+
+	//ڵ float  1ͬ
+	int64_t OrderedBits(float x)
+	{
+		int32_t i;
+		memcpy(&i, &x, 4);
+		return i < 0 ? (int64_t)(int32_t)0x80000000 - i : i;
+	}
+
+	struct Diff
+	{
+		double maxAbs = 0;
+		int64_t maxUlp = 0;
+		void Add(const std::vector<float>& a, const std::vector<float>& b)
+		{
+			for (size_t i = 0; i < a.size(); ++i)
+			{
+				double d = fabs((double)a[i] - b[i]);
+				if (d > maxAbs) maxAbs = d;
+				int64_t u = OrderedBits(a[i]) - OrderedBits(b[i]);
+				if (u < 0) u = -u;
+				if (u > maxUlp) maxUlp = u;
+			}
+		}
+		void Add(const Diff& d)
+		{
+			if (d.maxAbs > maxAbs) maxAbs = d.maxAbs;
+			if (d.maxUlp > maxUlp) maxUlp = d.maxUlp;
+		}
+	};
+
+	struct Output
+	{
+		std::vector<float> l, r;
+	};
+
+	int failures = 0;
+
+	void Fail(const char* fmt, ...)
+	{
+		if (++failures > 40) return;//Ķͬһԭ
+		va_list args;
+		va_start(args, fmt);
+		printf("FAIL ");
+		vprintf(fmt, args);
+		printf("\n");
+		va_end(args);
+	}
+
+	//컨壺ͬһ dB 㣬˷˳ҲһԿԾȷȽ
+	float Ceiling(const Setting& s)
+	{
+		return LMLimiterNamespace::DbToGain(s.threshold) * LMLimiterNamespace::DbToGain(s.output);
+	}
+
+	void CheckCeiling(const char* variant, const char* what, const Output& out, float ceiling)
+	{
+		float peak = 0;
+		for (size_t i = 0; i < out.l.size(); ++i)
+		{
+			peak = fabsf(out.l[i]) > peak ? fabsf(out.l[i]) : peak;
+			peak = fabsf(out.r[i]) > peak ? fabsf(out.r[i]) : peak;
+		}
+		if (peak > ceiling) Fail("%s / %s: peak %.9g exceeds ceiling %.9g", variant, what, (double)peak, (double)ceiling);
+	}
+
+	//ȥʱ룬ĩβʱ
+	template<class Process>
+	Output Run(const Signal& sig, int latency, Process process)
+	{
+		const int n = (int)sig.l.size();
+		std::vector<float> l(n + latency, 0.0f), r(n + latency, 0.0f);
+		memcpy(l.data(), sig.l.data(), n * sizeof(float));
+		memcpy(r.data(), sig.r.data(), n * sizeof(float));
+		process(l.data(), r.data(), n + latency);
+		return { std::vector<float>(l.begin() + latency, l.end()), std::vector<float>(r.begin() + latency, r.end()) };
+	}
+
+	Output RunReference(const Signal& sig, const Setting& s, double sampleRate)
+	{
+		LMLimiterReference* ref = new LMLimiterReference();
+		ref->SetSampleRate((float)sampleRate);
+		ref->SetParams(s.lookahead, s.input, s.output, s.threshold, s.attack, s.release);
+		Output out = Run(sig, ref->GetLatencySamples(), [&](float* l, float* r, int n)
+		{
+			for (int start = 0; start < n; start += 512)
+			{
+				int m = n - start < 512 ? n - start : 512;
+				ref->ProcessBlock(l + start, r + start, l + start, r + start, m);
+			}
+		});
+		delete ref;
+		return out;
+	}
+
+	//blockSize <= 0鳤 1 ~ 1000 ֮
+	//CheckModes Ѹģʽ򿪣ﶼػԭΪ
+	void ResetLimiter(LMLimiter& lim, const Setting& s, double sampleRate, LMLimiterNamespace::cpu::Isa isa)
+	{
+		lim.SetIsa(isa);
+		lim.SetSampleRate((float)sampleRate);
+		lim.SetParams(s.lookahead, s.input, s.output, s.threshold, s.attack, s.release);
+		lim.SetSmoothAttack(false);
+		lim.SetEconomy(1);
+		lim.SetLeveler(false, 0, 1, 1);
+		lim.SetAdaptiveRelease(0);
+		lim.SetClipKnee(0);
+		lim.SetMidSide(false, 0, 0);
+		lim.Reset();
+	}
+
+	Output RunLimiter(LMLimiter& lim, const Signal& sig, const Setting& s, double sampleRate,
+		LMLimiterNamespace::cpu::Isa isa, int blockSize)
+	{
+		ResetLimiter(lim, s, sampleRate, isa);
+		Rng rng;
+		return Run(sig, lim.GetLatencySamples(), [&](float* l, float* r, int n)
+		{
+			for (int start = 0; start < n;)
+			{
+				int m = blockSize > 0 ? blockSize : 1 + (int)rng.Uniform(0, 1000);
+				if (m > n - start) m = n - start;
+				lim.SetParams(s.lookahead, s.input, s.output, s.threshold, s.attack, s.release);
+				lim.ProcessBlock(l + start, r + start, l + start, r + start, m);
+				start += m;
+			}
+		});
+	}
+
+	//numChannels 4 ʱ 23 һ֪ݣԭ
+	Output RunCApi(const Signal& sig, const Setting& s, double sampleRate, bool interleaved, int numChannels)
+	{
+		const size_t align = lmlimiter_instance_alignment();
+		const size_t size = lmlimiter_instance_size();
+		std::vector<unsigned char> storage(size + align);
+		void* mem = storage.data() + (align - (uintptr_t)storage.data() % align) % align;
+		lmlimiter* lim = lmlimiter_create(mem, size);
+		lmlimiter_set_param(lim, LMLIMITER_PARAM_LOOKAHEAD_MS, s.lookahead);
+		lmlimiter_set_param(lim, LMLIMITER_PARAM_ATTACK_MS, s.attack);
+		lmlimiter_set_param(lim, LMLIMITER_PARAM_RELEASE_MS, s.release);
+		lmlimiter_set_param(lim, LMLIMITER_PARAM_INPUT_DB, s.input);
+		lmlimiter_set_param(lim, LMLIMITER_PARAM_OUTPUT_DB, s.output);
+		lmlimiter_set_param(lim, LMLIMITER_PARAM_THRESHOLD_DB, s.threshold);
+		lmlimiter_prepare(lim, sampleRate);
+		Output out = Run(sig, lmlimiter_get_latency_samples(lim), [&](float* l, float* r, int n)
+		{
+			auto extra = [](int c, int i) { return (float)(c * 1000 + i % 1000); };
+			bool passed = true;
+			if (interleaved)
+			{
+				std::vector<float> x((size_t)n * numChannels);
+				for (int i = 0; i < n; ++i)
+				{
+					x[i * numChannels] = l[i];
+					x[i * numChannels + 1] = r[i];
+					for (int c = 2; c < numChannels; ++c) x[i * numChannels + c] = extra(c, i);
+				}
+				if (lmlimiter_process_interleaved(lim, x.data(), x.data(), numChannels, n) != 0) passed = false;
+				for (int i = 0; i < n; ++i)
+				{
+					l[i] = x[i * numChannels];
+					r[i] = x[i * numChannels + 1];
+					for (int c = 2; c < numChannels; ++c) passed = passed && x[i * numChannels + c] == extra(c, i);
+				}
+			}
+			else
+			{
+				std::vector<float> x((size_t)n * 2), y((size_t)n * 2);
+				const float* in[4] = { l, r, x.data(), x.data() + n };
+				float* out[4] = { l, r, y.data(), y.data() + n };
+				for (int i = 0; i < n; ++i)
+				{
+					x[i] = extra(2, i);
+					x[n + i] = extra(3, i);
+				}
+				if (lmlimiter_process_planar(lim, in, out, numChannels, n) != 0) passed = false;
+				for (int i = 0; numChannels > 2 && i < n; ++i) passed = passed && y[i] == x[i] && y[n + i] == x[n + i];
+			}
+			if (!passed) Fail("C API %s, %d channels: extra channels not passed through", interleaved ? "interleaved" : "planar", numChannels);
+		});
+		lmlimiter_destroy(lim);
+		return out;
+	}
+
+	//Ҫش󣬶Ҳ
+	void CheckCApiArguments()
+	{
+		const size_t align = lmlimiter_instance_alignment();
+		const size_t size = lmlimiter_instance_size();
+		std::vector<unsigned char> storage(size + align);
+		void* mem = storage.data() + (align - (uintptr_t)storage.data() % align) % align;
+		lmlimiter* lim = lmlimiter_create(mem, size);
+		lmlimiter_prepare(lim, 48000);
+		float buf[4] = { 5, 5, 5, 5 };
+		const float* in[1] = { buf };
+		float* out[1] = { buf };
+		if (lmlimiter_process_planar(lim, in, out, 0, 4) != -1) Fail("C API planar: 0 channels accepted");
+		if (lmlimiter_process_interleaved(lim, buf, buf, 0, 4) != -1) Fail("C API interleaved: 0 channels accepted");
+		if (lmlimiter_process_interleaved(lim, buf, buf, -2, 2) != -1) Fail("C API interleaved: -2 channels accepted");
+		if (lmlimiter_process_planar(lim, in, out, 1, -1) != -1) Fail("C API planar: negative frame count accepted");
+		if (buf[0] != 5 || buf[3] != 5) Fail("C API: rejected call touched the buffer");
+		lmlimiter_destroy(lim);
+	}
+
+	//һ batch ·ͬһ lookaheadʱ·
+	//lane k ź k % źô k / ź ʼҵһ lookahead ͬ
+	//ÿָһ飺Ͳοͱں˱λͬ SetSampleRateû˳Ҫ
+	template<int Lanes>
+	void CheckBatch(const std::vector<Signal>& corpus, const std::vector<std::vector<Output>>& refs,
+		double sampleRate, float lookahead, Diff& total, Diff& isaTotal)
+	{
+		using namespace LMLimiterNamespace::cpu;
+		const int numSignals = (int)corpus.size();
+		const int n = (int)corpus[0].l.size();
+		int settingOf[Lanes];
+		for (int k = 0; k < Lanes; ++k)
+		{
+			int idx = 0;
+			for (int tries = 0; tries < NumSettings; ++tries)
+			{
+				idx = (k / numSignals + tries) % NumSettings;
+				if (Settings[idx].lookahead == lookahead) break;
+			}
+			settingOf[k] = idx;
+		}
+
+		std::vector<Output> scalarOut(Lanes);
+		LMLimiterBatch<Lanes>* batch = new LMLimiterBatch<Lanes>();
+		for (int isa = 0; isa <= (int)DetectIsa(); ++isa)
+		{
+			batch->SetIsa((Isa)isa);
+			for (int k = 0; k < Lanes; ++k)
+			{
+				const Setting& s = Settings[settingOf[k]];
+				batch->SetLaneParams(k, s.input, s.output, s.threshold, s.attack, s.release);
+			}
+			batch->SetLookahead(lookahead);
+			batch->SetSampleRate((float)sampleRate);
+			batch->Reset();
+			const int latency = batch->GetLatencySamples();
+
+			std::vector<float> bufL((size_t)Lanes * (n + latency), 0.0f), bufR((size_t)Lanes * (n + latency), 0.0f);
+			for (int k = 0; k < Lanes; ++k)
+			{
+				memcpy(bufL.data() + (size_t)k * (n + latency), corpus[k % numSignals].l.data(), n * sizeof(float));
+				memcpy(bufR.data() + (size_t)k * (n + latency), corpus[k % numSignals].r.data(), n * sizeof(float));
+			}
+			const int blockSize = 300;
+			for (int start = 0; start < n + latency; start += blockSize)
+			{
+				int m = n + latency - start < blockSize ? n + latency - start : blockSize;
+				const float* inL[Lanes];
+				const float* inR[Lanes];
+				float* outL[Lanes];
+				float* outR[Lanes];
+				for (int k = 0; k < Lanes; ++k)
+				{
+					outL[k] = bufL.data() + (size_t)k * (n + latency) + start;
+					outR[k] = bufR.data() + (size_t)k * (n + latency) + start;
+					inL[k] = outL[k];
+					inR[k] = outR[k];
+				}
+				batch->ProcessBlock(inL, inR, outL, outR, m);
+			}
+
+			char name[64];
+			snprintf(name, sizeof(name), "batch x%d %s", Lanes, IsaName(batch->GetIsa()));
+			for (int k = 0; k < Lanes; ++k)
+			{
+				const Setting& s = Settings[settingOf[k]];
+				const float* l = bufL.data() + (size_t)k * (n + latency) + latency;
+				const float* r = bufR.data() + (size_t)k * (n + latency) + latency;
+				Output out{ std::vector<float>(l, l + n), std::vector<float>(r, r + n) };
+				const Output& ref = refs[k % numSignals][settingOf[k]];
+				Diff d;
+				d.Add(out.l, ref.l);
+				d.Add(out.r, ref.r);
+				total.Add(d);
+				if (d.maxAbs > RefTolerance * Ceiling(s))
+					Fail("%s / %s: max abs error %.3g, tolerance %.3g", name, s.name, d.maxAbs, RefTolerance * Ceiling(s));
+				CheckCeiling(name, s.name, out, Ceiling(s));
+				if (isa == 0)
+				{
+					scalarOut[k] = std::move(out);
+					continue;
+				}
+				Diff di;
+				di.Add(out.l, scalarOut[k].l);
+				di.Add(out.r, scalarOut[k].r);
+				isaTotal.Add(di);
+				if (di.maxUlp != 0) Fail("%s / %s: differs from scalar kernels by %lld ulp", name, s.name, (long long)di.maxUlp);
+			}
+		}
+		delete batch;
+	}
+
+	void PrintRow(const char* variant, const char* against, const Diff& d)
+	{
+		printf("  %-34s vs %-10s max abs %.3e  max ulp %lld\n", variant, against, d.maxAbs, (long long)d.maxUlp);
+	}
+
+	//ģʽûвοɱȣֻ컨
+	void CheckModes(LMLimiter& lim, const std::vector<Signal>& corpus, double sampleRate)
+	{
+		struct Mode
+		{
+			const char* name;
+			bool smooth;
+			int economy;
+			bool twoStage;
+			bool midSide;
+			float adaptive, clipKnee;
+			bool sidechain, moveLookahead;
+		};
+		const Mode modes[] = {
+			{ "smooth attack", true, 1, false, false, 0, 0, false, false },
+			{ "economy 8", false, 8, false, false, 0, 0, false, false },
+			{ "economy 32", false, 32, false, false, 0, 0, false, false },
+			{ "two stage", false, 1, true, false, 0, 0, false, false },
+			{ "mid/side", false, 1, false, true, 0, 0, false, false },
+			{ "adaptive release", false, 1, false, false, 1, 0, false, false },
+			{ "clip knee 6dB", false, 1, false, false, 0, 6, false, false },
+			{ "sidechain", false, 1, false, false, 0, 0, true, false },
+			{ "lookahead glide", false, 1, false, false, 0, 0, false, true },
+			{ "everything", true, 8, true, true, 1, 3, true, true },
+		};
+		const float midOffset = 2.0f, sideOffset = -4.0f;
+		for (const Mode& m : modes)
+		{
+			for (const Setting& s : Settings)
+			{
+				for (size_t k = 0; k < corpus.size(); ++k)
+				{
+					const Signal& sig = corpus[k];
+					const Signal& key = corpus[(k + 3) % corpus.size()];
+					lim.SetIsa(LMLimiterNamespace::cpu::Isa::Scalar);
+					lim.SetSampleRate((float)sampleRate);
+					lim.SetParams(s.lookahead, s.input, s.output, s.threshold, s.attack, s.release);
+					lim.SetSmoothAttack(m.smooth);
+					lim.SetEconomy(m.economy);
+					lim.SetLeveler(m.twoStage, -3, 30, 300);
+					lim.SetAdaptiveRelease(m.adaptive);
+					lim.SetClipKnee(m.clipKnee);
+					lim.SetMidSide(m.midSide, midOffset, sideOffset);
+					lim.Reset();
+					Rng rng;
+					const int n = (int)sig.l.size();
+					std::vector<float> l(sig.l), r(sig.r);
+					for (int start = 0; start < n;)
+					{
+						int len = 1 + (int)rng.Uniform(0, 700);
+						if (len > n - start) len = n - start;
+						float lookahead = s.lookahead;
+						if (m.moveLookahead) lookahead = fmod(start / sampleRate, 0.2) < 0.1 ? s.lookahead : 20.0f - s.lookahead;
+						lim.SetParams(lookahead, s.input, s.output, s.threshold, s.attack, s.release);
+						lim.ProcessBlock(l.data() + start, r.data() + start, l.data() + start, r.data() + start, len,
+							m.sidechain ? key.l.data() + start : nullptr, m.sidechain ? key.r.data() + start : nullptr);
+						start += len;
+					}
+					float ceiling = Ceiling(s);
+					if (m.midSide)
+						ceiling = LMLimiterNamespace::DbToGain(s.threshold) * LMLimiterNamespace::DbToGain(midOffset) * LMLimiterNamespace::DbToGain(s.output)
+						+ LMLimiterNamespace::DbToGain(s.threshold) * LMLimiterNamespace::DbToGain(sideOffset) * LMLimiterNamespace::DbToGain(s.output);
+					char what[96];
+					snprintf(what, sizeof(what), "%s / %s", s.name, sig.name);
+					CheckCeiling(m.name, what, { l, r }, ceiling);
+				}
+			}
+		}
+	}
+
+	//һ루attackʱȶˣֵֵ dBʾѹ
+	double PeakGaindB(const std::vector<float>& in, const std::vector<float>& out)
+	{
+		float peakIn = 0, peakOut = 0;
+		for (size_t i = in.size() / 2; i < in.size(); ++i)
+		{
+			peakIn = fmaxf(peakIn, fabsf(in[i]));
+			peakOut = fmaxf(peakOut, fabsf(out[i]));
+		}
+		return 20.0 * log10((double)peakOut / peakIn);
+	}
+
+	//⣺ֻ컨忴ձźţҪѹ
+	//ź + ĲҪѹȥӽ컨ź + Ĳѹ
+	void CheckSidechainDetection(LMLimiter& lim, double sampleRate)
+	{
+		const int n = (int)sampleRate;
+		std::vector<float> quiet(n), loud(n), keyLoud(n), keySilent(n, 0.0f);
+		for (int i = 0; i < n; ++i)
+		{
+			const double t = i / sampleRate;
+			quiet[i] = (float)(0.25 * sin(2.0 * M_PI * 1000.0 * t));
+			loud[i] = (float)(0.95 * sin(2.0 * M_PI * 1000.0 * t));
+			keyLoud[i] = (float)(4.0 * sin(2.0 * M_PI * 220.0 * t));
+		}
+		auto run = [&](const std::vector<float>& main, const std::vector<float>& key)
+		{
+			ResetLimiter(lim, Settings[0], sampleRate, LMLimiterNamespace::cpu::Isa::Scalar);
+			std::vector<float> l(main), r(main);
+			for (int start = 0; start < n; start += 512)
+			{
+				const int m = n - start < 512 ? n - start : 512;
+				lim.ProcessBlock(l.data() + start, r.data() + start, l.data() + start, r.data() + start, m,
+					key.data() + start, key.data() + start);
+			}
+			return PeakGaindB(main, l);
+		};
+		const double pumped = run(quiet, keyLoud);
+		const double untouched = run(loud, keySilent);
+		printf("  sidechain: quiet main + loud key %.2f dB, loud main + silent key %.2f dB\n", pumped, untouched);
+		if (!(pumped < -6.0)) Fail("sidechain: loud key on a quiet main only changed the level by %.2f dB", pumped);
+		if (!(fabs(untouched) < 0.01)) Fail("sidechain: silent key on a loud main changed the level by %.2f dB", untouched);
+	}
+
+	// + lookahead ر䣨ʱһֱڻ켶ļͷҪʵʱߣڳ弤֮ǰѹ
+	//ͷλʱ弤ǰزûѹ弤ֻձƽ컨صסҪ弤ǰѹ
+	void CheckTwoStageGlide(LMLimiter& lim, double sampleRate)
+	{
+		const int n = (int)sampleRate * 2;
+		const int period = (int)(sampleRate * 0.05);
+		std::vector<float> l(n), r(n);
+		for (int i = 0; i < n; ++i) l[i] = r[i] = i % period == period / 2 ? 4.0f : 0.5f;//ֱزϵĳ弤
+		ResetLimiter(lim, Settings[0], sampleRate, LMLimiterNamespace::cpu::Isa::Scalar);
+		lim.SetLeveler(true, 30, 30, 300);//޺ܸߣֻ켶
+		for (int start = 0; start < n; start += 256)
+		{
+			const float lookahead = fmod(start / sampleRate, 0.2) < 0.1 ? 2.0f : 18.0f;
+			lim.SetParams(lookahead, 0, 0, 0, 1, 10);
+			const int m = n - start < 256 ? n - start : 256;
+			lim.ProcessBlock(l.data() + start, r.data() + start, l.data() + start, r.data() + start, m);
+		}
+		//ÿ弤λãһǰ漸ֵܿϳһ㣩زѹ˶
+		//ͷûĶʱʱ켶ҪôñҪô絽ִѾˣ弤ǰ漸ѹֻʣ
+		int late = 0, impulses = 0;
+		float worst = 0;
+		for (int start = period; start + period <= n; start += period)
+		{
+			int peak = start;
+			for (int i = start; i < start + period; ++i)
+				if (fabsf(l[i]) > fabsf(l[peak])) peak = i;
+			if (peak - 3 < start) continue;
+			++impulses;
+			const float before = fabsf(l[peak - 3]) / 0.5f;
+			worst = fmaxf(worst, before);
+			if (before > 0.95f) ++late;
+		}
+		printf("  two stage + lookahead glide: %d impulses, worst gain 3 samples before the peak %.2f dB\n",
+			impulses, 20.0 * log10(worst));
+		if (impulses < 20) Fail("two stage glide: only %d impulses found", impulses);
+		if (late) Fail("two stage glide: %d of %d impulses not reduced before they reached the output", late, impulses);
+	}
+}
+
+int main()
+{
+	using namespace LMLimiterNamespace::cpu;
+	CheckCApiArguments();
+	LMLimiter* lim = new LMLimiter();
+	const double sampleRates[] = { 44100, 96000 };
+	for (double sampleRate : sampleRates)
+	{
+		printf("%.0f Hz\n", sampleRate);
+		const std::vector<Signal> corpus = MakeCorpus(sampleRate);
+
+		//ο[ź][]
+		std::vector<std::vector<Output>> refs(corpus.size());
+		for (size_t k = 0; k < corpus.size(); ++k)
+			for (const Setting& s : Settings) refs[k].push_back(RunReference(corpus[k], s, sampleRate));
+
+		Diff refDiff, isaDiff[4], blockDiff, capiDiff;
+		for (size_t k = 0; k < corpus.size(); ++k)
+		{
+			for (int si = 0; si < NumSettings; ++si)
+			{
+				const Setting& s = Settings[si];
+				const Signal& sig = corpus[k];
+				const Output& ref = refs[k][si];
+				char what[96];
+				snprintf(what, sizeof(what), "%s / %s", s.name, sig.name);
+
+				//12ںˣ鳤 512
+				Output base = RunLimiter(*lim, sig, s, sampleRate, Isa::Scalar, 512);
+				Diff d;
+				d.Add(base.l, ref.l);
+				d.Add(base.r, ref.r);
+				refDiff.Add(d);
+				if (d.maxAbs > RefTolerance * Ceiling(s))
+					Fail("LMLimiter / %s: max abs error %.3g, tolerance %.3g", what, d.maxAbs, RefTolerance * Ceiling(s));
+				CheckCeiling("LMLimiter", what, base, Ceiling(s));
+
+				//3ָ
+				for (int isa = 1; isa <= (int)DetectIsa(); ++isa)
+				{
+					Output out = RunLimiter(*lim, sig, s, sampleRate, (Isa)isa, 512);
+					Diff di;
+					di.Add(out.l, base.l);
+					di.Add(out.r, base.r);
+					isaDiff[isa].Add(di);
+					if (di.maxUlp != 0) Fail("%s kernels / %s: differ from scalar by %lld ulp", IsaName((Isa)isa), what, (long long)di.maxUlp);
+					CheckCeiling(IsaName((Isa)isa), what, out, Ceiling(s));
+				}
+
+				//3鳤ұ䣨ӿзֺͿ߽޹أ
+				Output varied = RunLimiter(*lim, sig, s, sampleRate, SelectIsa(), 0);
+				Diff db;
+				db.Add(varied.l, base.l);
+				db.Add(varied.r, base.r);
+				blockDiff.Add(db);
+				if (db.maxUlp != 0) Fail("varied block size / %s: differs from 512 by %lld ulp", what, (long long)db.maxUlp);
+
+				//3C API
+				for (int interleaved = 0; interleaved < 2; ++interleaved)
+				{
+					for (int numChannels = 2; numChannels <= 4; numChannels += 2)
+					{
+						Output out = RunCApi(sig, s, sampleRate, interleaved != 0, numChannels);
+						Diff dc;
+						dc.Add(out.l, base.l);
+						dc.Add(out.r, base.r);
+						capiDiff.Add(dc);
+						if (dc.maxUlp != 0)
+							Fail("C API %s, %d channels / %s: differs by %lld ulp", interleaved ? "interleaved" : "planar", numChannels, what, (long long)dc.maxUlp);
+					}
+				}
+			}
+		}
+
+		//4ÿ lookahead һ batch
+		Diff batchDiff[2], batchIsaDiff[2];
+		for (const Setting& s : Settings)
+		{
+			CheckBatch<8>(corpus, refs, sampleRate, s.lookahead, batchDiff[0], batchIsaDiff[0]);
+			CheckBatch<16>(corpus, refs, sampleRate, s.lookahead, batchDiff[1], batchIsaDiff[1]);
+		}
+
+		PrintRow("LMLimiter (scalar kernels)", "reference", refDiff);
+		for (int isa = 1; isa <= (int)DetectIsa(); ++isa)
+		{
+			char name[64];
+			snprintf(name, sizeof(name), "LMLimiter (%s kernels)", IsaName((Isa)isa));
+			PrintRow(name, "scalar", isaDiff[isa]);
+		}
+		PrintRow("LMLimiter (varied blocks)", "scalar", blockDiff);
+		PrintRow("C API (2 and 4 channels)", "scalar", capiDiff);
+		PrintRow("LMLimiterBatch<8>", "reference", batchDiff[0]);
+		PrintRow("LMLimiterBatch<8> (SIMD kernels)", "scalar", batchIsaDiff[0]);
+		PrintRow("LMLimiterBatch<16>", "reference", batchDiff[1]);
+		PrintRow("LMLimiterBatch<16> (SIMD kernels)", "scalar", batchIsaDiff[1]);
+
+		//5ģʽ
+		CheckModes(*lim, corpus, sampleRate);
+		CheckSidechainDetection(*lim, sampleRate);
+		CheckTwoStageGlide(*lim, sampleRate);
+	}
+	delete lim;
+
+	if (failures)
+	{
+		printf("%d checks failed\n", failures);
+		return 1;
+	}
+	printf("all variants within tolerance of the reference, ceiling holds everywhere\n");
+	return 0;
+}
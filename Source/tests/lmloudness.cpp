@@ -0,0 +1,252 @@
+/*
+lmlimiter_loudness: LMLoudnessMeter ľ
+	1. EBU Tech 3341 ĺϳźţ 1kHz ң-23 / -33 dBFS  MSI ſصļе I 0.1 LU
+	2. EBU Tech 3342  LRA ϳźţ/βͬƽңLRA  1 LU׼ݲ
+	3. GateHistogramۼƵſأͰȫſؿȷĽȣ
+		I  < 0.1 LULRA ȡӱϵľȷֵһڣ;ȷֵ < 1 LU
+ 44100  48000 ܣκһ㷵 1
+*/
+
+#include "../dsp/lmloudness.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+namespace
+{
+	using LMLoudnessNamespace::EnergyToLUFS;
+	using LMLoudnessNamespace::GateHistogram;
+
+	constexpr double ToneTolerance = 0.1;//Tech 3341M/S/I 0.1 LU
+	constexpr double RangeTolerance = 1.0;//Tech 3342LRA 1 LU
+
+	int failures = 0;
+
+	void Fail(const char* fmt, ...)
+	{
+		if (++failures > 40) return;
+		va_list args;
+		va_start(args, fmt);
+		printf("FAIL: ");
+		vprintf(fmt, args);
+		printf("\n");
+		va_end(args);
+	}
+
+	struct Segment
+	{
+		double dBFS, seconds;
+	};
+
+	// 1kHz ҡֵ dBFS˳һһͽ鳤ⲻ 100ms
+	LMLoudnessMeter::Values Measure(LMLoudnessMeter& meter, float sampleRate, const std::vector<Segment>& segments)
+	{
+		meter.SetSampleRate(sampleRate);
+		constexpr int BlockSize = 1000;
+		std::vector<float> l(BlockSize), r(BlockSize);
+		double phase = 0;
+		const double step = 2.0 * M_PI * 1000.0 / sampleRate;
+		for (const Segment& seg : segments)
+		{
+			const double amp = pow(10.0, seg.dBFS / 20.0);
+			int64_t remaining = (int64_t)(seg.seconds * sampleRate + 0.5);
+			while (remaining > 0)
+			{
+				const int n = remaining < BlockSize ? (int)remaining : BlockSize;
+				for (int i = 0; i < n; ++i)
+				{
+					l[i] = r[i] = (float)(amp * sin(phase));
+					phase += step;
+					if (phase > 2.0 * M_PI) phase -= 2.0 * M_PI;
+				}
+				meter.ProcessBlock(l.data(), r.data(), n);
+				meter.Update();
+				remaining -= n;
+			}
+		}
+		meter.Update();
+		return meter.GetValues();
+	}
+
+	void Expect(const char* what, const char* reading, float sampleRate, double value, double expected, double tolerance)
+	{
+		printf("  %-34s %-3s %8.3f (expected %.1f)\n", what, reading, value, expected);
+		if (!(fabs(value - expected) <= tolerance))
+			Fail("%s @ %.0f Hz: %s = %.3f, expected %.1f +-%.1f", what, sampleRate, reading, value, expected, tolerance);
+	}
+
+	void CheckTech3341(LMLoudnessMeter& meter, float sampleRate)
+	{
+		//12㶨ƽM/S/I ڵƽ
+		const double levels[] = { -23.0, -33.0 };
+		for (double level : levels)
+		{
+			char what[64];
+			snprintf(what, sizeof(what), "3341 sine %.0f dBFS 20s", level);
+			LMLoudnessMeter::Values v = Measure(meter, sampleRate, { { level, 20 } });
+			Expect(what, "M", sampleRate, v.momentary, level, ToneTolerance);
+			Expect(what, "S", sampleRate, v.shortTerm, level, ToneTolerance);
+			Expect(what, "I", sampleRate, v.integrated, level, ToneTolerance);
+		}
+		//345͵ƽαţ4 оţI ֻ -23 
+		struct Case
+		{
+			const char* name;
+			std::vector<Segment> segments;
+		};
+		const Case cases[] = {
+			{ "3341 case 3 relative gate", { { -36, 10 }, { -23, 60 }, { -36, 10 } } },
+			{ "3341 case 4 absolute gate", { { -72, 10 }, { -36, 10 }, { -23, 60 }, { -36, 10 }, { -72, 10 } } },
+			{ "3341 case 5 -26/-20/-26", { { -26, 20 }, { -20, 20.1 }, { -26, 20 } } },
+		};
+		for (const Case& c : cases)
+		{
+			LMLoudnessMeter::Values v = Measure(meter, sampleRate, c.segments);
+			Expect(c.name, "I", sampleRate, v.integrated, -23.0, ToneTolerance);
+		}
+	}
+
+	void CheckTech3342(LMLoudnessMeter& meter, float sampleRate)
+	{
+		struct Case
+		{
+			const char* name;
+			std::vector<Segment> segments;
+			double lra;
+		};
+		const Case cases[] = {
+			{ "3342 case 1 -20/-30", { { -20, 20 }, { -30, 20 } }, 10 },
+			{ "3342 case 2 -20/-15", { { -20, 20 }, { -15, 20 } }, 5 },
+			{ "3342 case 3 -40/-20", { { -40, 20 }, { -20, 20 } }, 20 },
+			{ "3342 case 4 -50/-35/-20/-35/-50", { { -50, 20 }, { -35, 20 }, { -20, 20 }, { -35, 20 }, { -50, 20 } }, 15 },
+		};
+		for (const Case& c : cases)
+		{
+			LMLoudnessMeter::Values v = Measure(meter, sampleRate, c.segments);
+			Expect(c.name, "LRA", sampleRate, v.range, c.lra, RangeTolerance);
+		}
+	}
+
+	//ȷ BS.1770 / Tech 3342 ſأп鶼ţgateStep > 0 ʱȡ͸Ӷ룩
+	double ExactGate(const std::vector<double>& energies, double relativeGateLU, double gateStep)
+	{
+		double sum = 0;
+		int n = 0;
+		for (double e : energies)
+			if (EnergyToLUFS(e) >= GateHistogram::MinLUFS) { sum += e; ++n; }
+		double gate = EnergyToLUFS(sum / n) + relativeGateLU;
+		if (gateStep > 0) gate = GateHistogram::MinLUFS + floor((gate - GateHistogram::MinLUFS) / gateStep) * gateStep;
+		return gate;
+	}
+
+	double ExactIntegrated(const std::vector<double>& energies)
+	{
+		const double gate = ExactGate(energies, -10.0, 0);
+		double sum = 0;
+		int n = 0;
+		for (double e : energies)
+		{
+			const double lufs = EnergyToLUFS(e);
+			if (lufs >= GateHistogram::MinLUFS && lufs >= gate) { sum += e; ++n; }
+		}
+		return EnergyToLUFS(sum / n);
+	}
+
+	double ExactRange(const std::vector<double>& energies, double gateStep)
+	{
+		const double gate = ExactGate(energies, -20.0, gateStep);
+		std::vector<double> gated;
+		for (double e : energies)
+		{
+			const double lufs = EnergyToLUFS(e);
+			if (lufs >= GateHistogram::MinLUFS && lufs >= gate) gated.push_back(lufs);
+		}
+		std::sort(gated.begin(), gated.end());
+		const size_t n = gated.size();
+		return gated[(size_t)((n - 1) * 0.95)] - gated[(size_t)((n - 1) * 0.10)];
+	}
+
+	struct Rng
+	{
+		uint32_t state = 1;
+		double Uniform()
+		{
+			state = state * 1664525u + 1013904223u;
+			return (state >> 8) * (1.0 / 16777216.0);
+		}
+		double Normal()//12 ȷֲӣƱ׼̬
+		{
+			double sum = 0;
+			for (int i = 0; i < 12; ++i) sum += Uniform();
+			return sum - 6.0;
+		}
+	};
+
+	void CheckGateHistogram()
+	{
+		const double binWidth = 1.0 / GateHistogram::BinsPerLU;
+		double worstI = 0, worstRangeBin = 0, worstRange = 0;
+		Rng rng;
+		GateHistogram* hist = new GateHistogram();
+		for (int trial = 0; trial < 600; ++trial)
+		{
+			//ֲַߵĽĿȡ-60~-5 ȡ-23 ̬ 100  3000 
+			std::vector<double> energies;
+			const int n = 100 + (trial * 37) % 2900;
+			const double spread = 1 + trial % 10;
+			double level = -23;
+			for (int i = 0; i < n; ++i)
+			{
+				double lufs;
+				switch (trial % 3)
+				{
+				case 0:
+					level = std::min(std::max(level + 0.3 * rng.Normal(), -50.0), -5.0);
+					lufs = level + 0.3 * spread * rng.Normal();
+					break;
+				case 1:
+					lufs = -60 + 55 * rng.Uniform();
+					break;
+				default:
+					lufs = -23 + spread * rng.Normal();
+					break;
+				}
+				energies.push_back(pow(10.0, (lufs + 0.691) / 10.0));
+			}
+			hist->Clear();
+			for (double e : energies) hist->Add(e);
+			worstI = std::max(worstI, fabs(hist->GatedLoudness(-10.0f) - ExactIntegrated(energies)));
+			const double range = hist->GatedRange(-20.0f, 10.0f, 95.0f);
+			worstRangeBin = std::max(worstRangeBin, fabs(range - ExactRange(energies, binWidth)));
+			worstRange = std::max(worstRange, fabs(range - ExactRange(energies, 0)));
+		}
+		delete hist;
+		printf("  GateHistogram vs exact gating: I %.4f LU, LRA %.4f LU (%.4f with the gate on the bin edge)\n",
+			worstI, worstRange, worstRangeBin);
+		if (!(worstI < 0.1)) Fail("GateHistogram: integrated loudness off by %.4f LU", worstI);
+		if (!(worstRangeBin <= binWidth + 1e-4)) Fail("GateHistogram: LRA off by %.4f LU with the same gate", worstRangeBin);
+		if (!(worstRange < RangeTolerance)) Fail("GateHistogram: LRA off by %.4f LU", worstRange);
+	}
+}
+
+int main()
+{
+	LMLoudnessMeter* meter = new LMLoudnessMeter();
+	const float sampleRates[] = { 44100.0f, 48000.0f };
+	for (float sampleRate : sampleRates)
+	{
+		printf("%.0f Hz\n", sampleRate);
+		CheckTech3341(*meter, sampleRate);
+		CheckTech3342(*meter, sampleRate);
+	}
+	delete meter;
+	CheckGateHistogram();
+
+	if (failures) printf("%d failure(s)\n", failures);
+	else printf("all loudness checks passed\n");
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <string.h>
+#include <deque>
+
+/*
+LMLimiterReference: Ĳοʵ֣ı LMLimiter::ProcessBlockpowfstd::deque
+ֻȥ˵ƽlmlimiter_golden Żİ汾Ա
+Ҫļǲ䡣ԭĹִҲճ
+attack Ļ׼ǹ̶ 480 Ա lookaheadSamples ûֵֻʱջ
+*/
+
+namespace LMReference
+{
+	template<int MaxDelaySamples>
+	class TinyDelay
+	{
+	private:
+		float buf[MaxDelaySamples] = { 0 };
+		int delaySamples = 0;
+		int pos = 0;
+	public:
+		TinyDelay()
+		{
+			memset(buf, 0, sizeof(buf));
+		}
+		void SetDelaySamples(int numSamples)
+		{
+			if (delaySamples == numSamples) return;
+			if (numSamples < 0)numSamples = 0;
+			if (numSamples >= MaxDelaySamples) numSamples = MaxDelaySamples - 1;
+			delaySamples = numSamples;
+			memset(buf, 0, sizeof(buf));
+		}
+		int GetDelaySamples() const
+		{
+			return delaySamples;
+		}
+		float ProcessSample(float inSample)
+		{
+			buf[(pos + delaySamples) % MaxDelaySamples] = inSample;
+			float outSample = buf[pos];
+			pos = (pos + 1) % MaxDelaySamples;
+			return outSample;
+		}
+	};
+
+	class SlidingWindowMax {
+	private:
+		struct Sample {
+			long long index;
+			float value;
+		};
+
+		std::deque<Sample> deque;
+		int windowSize;
+		long long currentIndex;
+
+	public:
+		SlidingWindowMax() : windowSize(0), currentIndex(0) {}
+
+		void SetWindowSize(int numSamples) {
+			if (windowSize == numSamples) {
+				return;
+			}
+
+			if (numSamples < 1) {
+				numSamples = 1;
+			}
+			windowSize = numSamples;
+			deque.clear();
+			currentIndex = 0;
+		}
+
+		float ProcessSample(float x) {
+			while (!deque.empty() && deque.back().value <= x) {
+				deque.pop_back();
+			}
+
+			deque.push_back({ currentIndex, x });
+
+			if (deque.front().index <= currentIndex - windowSize) {
+				deque.pop_front();
+			}
+
+			currentIndex++;
+
+			if (deque.empty()) return 0;//ֹdeque
+			return deque.front().value;
+		}
+	};
+}
+
+class LMLimiterReference {
+private:
+	float sampleRate = 48000.0;
+
+	LMReference::TinyDelay<4800> delayL;//100msʱ
+	LMReference::TinyDelay<4800> delayR;
+	LMReference::SlidingWindowMax swmL;
+	LMReference::SlidingWindowMax swmR;
+
+	float inputMul = 1.0, outputMul = 1.0, thresholdMul = 1.0;
+
+	float gainAddL = 0, gainAddR = 0;
+
+	float lookaheadSamples = 480.0f;
+	float attackTaw = 0.0f;
+	float releaseTaw = 0.0f;//releaseһһ׵ͨ
+
+public:
+	void SetSampleRate(float newSampleRate)
+	{
+		sampleRate = newSampleRate;
+	}
+	int GetLatencySamples() const
+	{
+		return delayL.GetDelaySamples();
+	}
+	void SetParams(float lookahead, float inputdB, float outputdB, float thresholddB, float attackMs, float releaseMs)
+	{
+		inputMul = powf(10.0f, inputdB / 20.0f);
+		outputMul = powf(10.0f, outputdB / 20.0f);
+		thresholdMul = powf(10.0f, thresholddB / 20.0f);
+
+		attackTaw = 1.0 / lookaheadSamples;//lookaheadʱĿֵ,Ȼٶٳһattackʱ䳣
+		attackTaw *= (1.0 + attackMs / 1000.0);//ӦattackMs(λ)
+		releaseTaw = 1.0f / (releaseMs * sampleRate / 1000.0f);
+
+		float lookaheadSamples = lookahead * sampleRate / 1000.0f + 2.0;
+		if (lookaheadSamples > 4800.0f) lookaheadSamples = 4800.0f;
+		delayL.SetDelaySamples(lookaheadSamples);
+		delayR.SetDelaySamples(lookaheadSamples);
+		swmL.SetWindowSize(lookaheadSamples);
+		swmR.SetWindowSize(lookaheadSamples);
+	}
+	void ProcessBlock(const float* inL, const float* inR, float* outL, float* outR, int numSamples)
+	{
+		for (int i = 0; i < numSamples; ++i)
+		{
+			float inl = inL[i] * inputMul / thresholdMul;
+			float inr = inR[i] * inputMul / thresholdMul;
+			float vl1 = fabsf(inl) - 1.0;
+			float vr1 = fabsf(inr) - 1.0;
+			vl1 = (vl1 > 0) ? vl1 : 0;
+			vr1 = (vr1 > 0) ? vr1 : 0;
+
+			float smaxL = swmL.ProcessSample(vl1);//㻬ֵ
+			float smaxR = swmR.ProcessSample(vr1);
+			float dlyL = delayL.ProcessSample(inl);//ʱ
+			float dlyR = delayR.ProcessSample(inr);
+
+			if (smaxL > gainAddL)
+			{
+				gainAddL += smaxL * attackTaw;//lookaheadʱĿֵ
+				if (gainAddL > smaxL) gainAddL = smaxL;
+			}
+			else
+			{
+				gainAddL += releaseTaw * (smaxL - gainAddL);
+			}
+			if (smaxR > gainAddR)
+			{
+				gainAddR += smaxR * attackTaw;//lookaheadʱĿֵ
+				if (gainAddR > smaxR) gainAddR = smaxR;
+			}
+			else
+			{
+				gainAddR += releaseTaw * (smaxR - gainAddR);
+			}
+
+			//ձlookaheadû׼õǿ
+			float dlyvl = fabsf(dlyL) - 1.0;
+			float dlyvr = fabsf(dlyR) - 1.0;
+			if (dlyvl > gainAddL) gainAddL = dlyvl;
+			if (dlyvr > gainAddR) gainAddR = dlyvr;
+
+			float outl = dlyL / (1.0f + gainAddL);
+			float outr = dlyR / (1.0f + gainAddR);
+			if (outl > 1.0f) outl = 1.0f;//ɣ
+			if (outl < -1.0f) outl = -1.0f;
+
+			outL[i] = outl * thresholdMul * outputMul;//Ӧ油
+			outR[i] = outr * thresholdMul * outputMul;
+		}
+	}
+};
@@ -0,0 +1,210 @@
+#include "lmrtguard.h"
+
+#include <atomic>
+#include <errno.h>
+#include <new>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+//glibc ԭʼ亯תã dlsym  mallocdlsym ԼҲ
+extern "C"
+{
+	void* __libc_malloc(size_t size);
+	void* __libc_calloc(size_t count, size_t size);
+	void* __libc_realloc(void* p, size_t size);
+	void* __libc_memalign(size_t alignment, size_t size);
+	void __libc_free(void* p);
+}
+
+namespace
+{
+	thread_local int scopeDepth = 0;
+	std::atomic<long long> counts[LMRt::NumKinds];
+
+	inline void Note(int kind)
+	{
+		if (scopeDepth > 0) counts[kind].fetch_add(1, std::memory_order_relaxed);
+	}
+
+	//ú static ָ룺ĳʼ pthread_mutex_lockݹ
+	using LockFn = int (*)(pthread_mutex_t*);
+	std::atomic<LockFn> realLock{ nullptr };
+	std::atomic<LockFn> realTryLock{ nullptr };
+
+	LockFn Resolve(std::atomic<LockFn>& fn, const char* name)
+	{
+		LockFn f = fn.load(std::memory_order_acquire);
+		if (!f)
+		{
+			f = (LockFn)dlsym(RTLD_NEXT, name);
+			fn.store(f, std::memory_order_release);
+		}
+		return f;
+	}
+
+	void* NewImpl(size_t size, size_t alignment)
+	{
+		Note(LMRt::New);
+		if (size == 0) size = 1;
+		return alignment ? __libc_memalign(alignment, size) : __libc_malloc(size);
+	}
+
+	void DeleteImpl(void* p)
+	{
+		if (p) Note(LMRt::Delete);
+		__libc_free(p);
+	}
+}
+
+namespace LMRt
+{
+	const char* KindName(int kind)
+	{
+		switch (kind)
+		{
+		case Malloc: return "malloc";
+		case Free: return "free";
+		case New: return "operator new";
+		case Delete: return "operator delete";
+		case MutexLock: return "pthread_mutex_lock";
+		default: return "?";
+		}
+	}
+
+	Scope::Scope() { ++scopeDepth; }
+	Scope::~Scope() { --scopeDepth; }
+
+	long long GetCount(int kind)
+	{
+		return counts[kind].load(std::memory_order_relaxed);
+	}
+
+	long long GetTotal()
+	{
+		long long total = 0;
+		for (int k = 0; k < NumKinds; ++k) total += GetCount(k);
+		return total;
+	}
+
+	void ResetCounts()
+	{
+		for (int k = 0; k < NumKinds; ++k) counts[k].store(0, std::memory_order_relaxed);
+	}
+
+	bool SelfTest()
+	{
+		ResetCounts();
+		{
+			Scope scope;
+			void* volatile p = malloc(16);
+			free(p);
+			int* volatile q = new int(1);
+			delete q;
+			pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+			pthread_mutex_lock(&m);
+			pthread_mutex_unlock(&m);
+		}
+		bool ok = true;
+		for (int k = 0; k < NumKinds; ++k) ok = ok && GetCount(k) > 0;
+		ResetCounts();
+		return ok;
+	}
+}
+
+extern "C"
+{
+	void* malloc(size_t size) noexcept
+	{
+		Note(LMRt::Malloc);
+		return __libc_malloc(size);
+	}
+	void* calloc(size_t count, size_t size) noexcept
+	{
+		Note(LMRt::Malloc);
+		return __libc_calloc(count, size);
+	}
+	void* realloc(void* p, size_t size) noexcept
+	{
+		Note(LMRt::Malloc);
+		return __libc_realloc(p, size);
+	}
+	void* memalign(size_t alignment, size_t size) noexcept
+	{
+		Note(LMRt::Malloc);
+		return __libc_memalign(alignment, size);
+	}
+	void* aligned_alloc(size_t alignment, size_t size) noexcept
+	{
+		Note(LMRt::Malloc);
+		return __libc_memalign(alignment, size);
+	}
+	int posix_memalign(void** p, size_t alignment, size_t size) noexcept
+	{
+		Note(LMRt::Malloc);
+		if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) return EINVAL;
+		void* q = __libc_memalign(alignment, size);
+		if (!q) return ENOMEM;
+		*p = q;
+		return 0;
+	}
+	void free(void* p) noexcept
+	{
+		if (p) Note(LMRt::Free);
+		__libc_free(p);
+	}
+
+	int pthread_mutex_lock(pthread_mutex_t* m) noexcept
+	{
+		Note(LMRt::MutexLock);
+		return Resolve(realLock, "pthread_mutex_lock")(m);
+	}
+	int pthread_mutex_trylock(pthread_mutex_t* m) noexcept
+	{
+		Note(LMRt::MutexLock);
+		return Resolve(realTryLock, "pthread_mutex_trylock")(m);
+	}
+}
+
+void* operator new(size_t size)
+{
+	void* p = NewImpl(size, 0);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+void* operator new[](size_t size)
+{
+	void* p = NewImpl(size, 0);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+void* operator new(size_t size, std::align_val_t alignment)
+{
+	void* p = NewImpl(size, (size_t)alignment);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+	void* p = NewImpl(size, (size_t)alignment);
+	if (!p) throw std::bad_alloc();
+	return p;
+}
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return NewImpl(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return NewImpl(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return NewImpl(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return NewImpl(size, (size_t)alignment); }
+
+void operator delete(void* p) noexcept { DeleteImpl(p); }
+void operator delete[](void* p) noexcept { DeleteImpl(p); }
+void operator delete(void* p, size_t) noexcept { DeleteImpl(p); }
+void operator delete[](void* p, size_t) noexcept { DeleteImpl(p); }
+void operator delete(void* p, std::align_val_t) noexcept { DeleteImpl(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { DeleteImpl(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { DeleteImpl(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { DeleteImpl(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { DeleteImpl(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { DeleteImpl(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { DeleteImpl(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { DeleteImpl(p); }
@@ -0,0 +1,33 @@
+#pragma once
+
+/*
+lmrtguard: õʵʱȫ飨ֻ֧ Linux/glibc
+lmrtguard.cpp ڿִļ¶ malloc/calloc/realloc/free/aligned_alloc/posix_memalign/memalign
+ʽ operator new/delete  pthread_mutex_lock/trylockת glibc ԭʵ֣
+ǰ߳ LMRt::Scope ڣ൱"Ƶص"ʱÿεüһΥ
+¼ֻԭӼӡӡҲܷ䣩ͱɵ÷ Scope 
+̣߳Ϣ̡̨̣߳߳ճ䣬Υ
+*/
+
+namespace LMRt
+{
+	enum Kind { Malloc = 0, Free, New, Delete, MutexLock, NumKinds };
+	const char* KindName(int kind);
+
+	///뿪ƵصǶ
+	class Scope
+	{
+	public:
+		Scope();
+		~Scope();
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+	};
+
+	long long GetCount(int kind);
+	long long GetTotal();
+	void ResetCounts();
+
+	//ûЧ类̬ӻ sanitizer ˣ Scope 䡢һΣû
+	bool SelfTest();
+}
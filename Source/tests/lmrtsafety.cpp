@@ -0,0 +1,311 @@
+/*
+lmlimiter_rtsafety: Ƶصﲻܷڴ桢ܼ
+ LModelAudioProcessor::processBlock ĵ˳ LMLimiterÿٴιȱ
+ɨֲʡ鳤ָÿ鶼䣬ʱ 64 ӿ裨Զֵһ
+lookahead һΣģʽУprepareSetSampleRate/Reset/SetIsaڻص棬Է
+ C API ĴҲͬһ
+صκ malloc/free/new/delete/pthread_mutex_lock ʧܣ 1
+ processBlock  lmlimiter_rtsafety_plugin 飨ֻҵ JUCE ʱ룩
+*/
+
+#include "../dsp/lmlimiter.h"
+#include "../dsp/lmlimiter_batch.h"
+#include "../dsp/lmloudness.h"
+#include "../capi/lmlimiter_c.h"
+#include "lmrtguard.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+	struct Rng
+	{
+		uint32_t state = 12345;
+		uint32_t NextU32()
+		{
+			state = state * 1664525u + 1013904223u;
+			return state;
+		}
+		float Uniform(float lo, float hi) { return lo + (hi - lo) * (NextU32() >> 8) * (1.0f / 16777216.0f); }
+		bool Chance(int oneIn) { return NextU32() % (uint32_t)oneIn == 0; }
+	};
+
+	//ͲĲһһӦΧҲһ
+	struct Params
+	{
+		float lookahead = 5, attack = 1, release = 10, input = 0, output = 0, threshold = 0, adaptive = 0;
+		bool smooth = false;
+		int economy = 0;
+		bool twoStage = false;
+		float levelThreshold = -3, levelAttack = 30, levelRelease = 300;
+		float clipKnee = 0;
+		bool sidechain = false;
+		bool midSide = false;
+		float midThreshold = 0, sideThreshold = 0;
+
+		void Randomize(Rng& rng, bool jumpLookahead)
+		{
+			if (jumpLookahead) lookahead = rng.Uniform(0, 20);
+			attack = rng.Uniform(0, 500);
+			release = rng.Uniform(4, 500);
+			input = rng.Uniform(-30, 30);
+			output = rng.Uniform(-30, 30);
+			threshold = rng.Uniform(-30, 30);
+			adaptive = rng.Uniform(0, 100);
+			levelThreshold = rng.Uniform(-12, 0);
+			levelAttack = rng.Uniform(1, 500);
+			levelRelease = rng.Uniform(10, 2000);
+			clipKnee = rng.Uniform(0, 6);
+			midThreshold = rng.Uniform(-12, 12);
+			sideThreshold = rng.Uniform(-12, 12);
+			//زУÿģʽܼ
+			if (rng.Chance(16)) smooth = !smooth;
+			if (rng.Chance(16)) economy = (int)(rng.NextU32() % 5);
+			if (rng.Chance(16)) twoStage = !twoStage;
+			if (rng.Chance(16)) sidechain = !sidechain;
+			if (rng.Chance(16)) midSide = !midSide;
+		}
+	};
+
+	//processBlock ÿ飨ÿԶӿ飩һ
+	void ApplyParams(LMLimiter& limiter, const Params& p)
+	{
+		limiter.SetSmoothAttack(p.smooth);
+		limiter.SetEconomy(p.economy == 0 ? 1 : 2 << p.economy);
+		limiter.SetParams(p.lookahead, p.input, p.output, p.threshold, p.attack, p.release);
+		limiter.SetAdaptiveRelease(p.adaptive / 100.0f);
+		limiter.SetLeveler(p.twoStage, p.levelThreshold, p.levelAttack, p.levelRelease);
+		limiter.SetClipKnee(p.clipKnee);
+		limiter.SetMidSide(p.midSide, p.midThreshold, p.sideThreshold);
+	}
+
+	// + ЪĴң֤һֱڶ
+	void FillSignal(Rng& rng, float* l, float* r, int n, double& phase, double sampleRate)
+	{
+		for (int i = 0; i < n; ++i)
+		{
+			float burst = fmod(phase, 1.0) < 0.5 ? 1.5f : 0.2f;
+			float s = (float)sin(phase * 2.0 * M_PI * 55.0);
+			l[i] = burst * s + rng.Uniform(-0.3f, 0.3f);
+			r[i] = burst * s * 0.5f + rng.Uniform(-0.6f, 0.6f);
+			phase += 1.0 / sampleRate;
+		}
+	}
+
+	int failures = 0;
+
+	// Scope ãղǴλصûΥ
+	void Check(const char* what, double sampleRate, int blockSize, int isa)
+	{
+		if (LMRt::GetTotal() == 0) return;
+		if (++failures <= 20)
+		{
+			printf("FAIL %s (%.0f Hz, block %d, %s):", what, sampleRate, blockSize,
+				LMLimiterNamespace::cpu::IsaName((LMLimiterNamespace::cpu::Isa)isa));
+			for (int k = 0; k < LMRt::NumKinds; ++k)
+				if (LMRt::GetCount(k)) printf(" %s x%lld", LMRt::KindName(k), LMRt::GetCount(k));
+			printf("\n");
+		}
+		LMRt::ResetCounts();
+	}
+
+	const double SampleRates[] = { 22050, 44100, 48000, 96000, 192000 };
+	const int BlockSizes[] = { 1, 17, 64, 100, 256, 512, 1000, 4096 };
+	constexpr int MaxBlockSize = 4096;
+
+	//ÿô顢ôʱ
+	int NumBlocks(double sampleRate, int blockSize)
+	{
+		int n = (int)(sampleRate * 0.25 / blockSize);
+		return n < 48 ? 48 : n;
+	}
+
+	void RunLimiter()
+	{
+		using namespace LMLimiterNamespace::cpu;
+		LMLimiter* limiter = new LMLimiter();
+		LMLoudnessMeter* loudness = new LMLoudnessMeter();
+		std::vector<float> inL(MaxBlockSize), inR(MaxBlockSize), keyL(MaxBlockSize), keyR(MaxBlockSize);
+		std::vector<float> outL(MaxBlockSize), outR(MaxBlockSize);
+		Rng rng;
+		double phase = 0;
+
+		for (int isa = 0; isa <= (int)DetectIsa(); ++isa)
+		{
+			for (double sampleRate : SampleRates)
+			{
+				for (int blockSize : BlockSizes)
+				{
+					//prepareToPlay
+					limiter->SetSampleRate((float)sampleRate);
+					limiter->Reset();
+					limiter->SetIsa((Isa)isa);
+					loudness->SetSampleRate((float)sampleRate);
+
+					Params p, last;
+					const int numBlocks = NumBlocks(sampleRate, blockSize);
+					for (int b = 0; b < numBlocks; ++b)
+					{
+						FillSignal(rng, inL.data(), inR.data(), blockSize, phase, sampleRate);
+						for (int i = 0; i < blockSize; ++i)
+						{
+							keyL[i] = inR[i] * 2.0f;
+							keyR[i] = inL[i] * 2.0f;
+						}
+						last = p;
+						p.Randomize(rng, b % 8 == 0);
+						const bool subBlocks = rng.Chance(2);
+						const float* kl = p.sidechain ? keyL.data() : nullptr;
+						const float* kr = p.sidechain && !rng.Chance(4) ? keyR.data() : nullptr;//ʱǵ
+						{
+							LMRt::Scope scope;
+							if (!subBlocks)
+							{
+								ApplyParams(*limiter, p);
+								limiter->ProcessBlock(inL.data(), inR.data(), outL.data(), outR.data(), blockSize, kl, kr);
+							}
+							else
+							{
+								for (int start = 0; start < blockSize; start += 64)
+								{
+									int n = blockSize - start < 64 ? blockSize - start : 64;
+									ApplyParams(*limiter, (start + n) * 2 < blockSize ? last : p);
+									limiter->ProcessBlock(inL.data() + start, inR.data() + start, outL.data() + start, outR.data() + start, n,
+										kl ? kl + start : nullptr, kr ? kr + start : nullptr);
+								}
+							}
+							loudness->ProcessBlock(outL.data(), outR.data(), blockSize);
+						}
+						Check("LMLimiter", sampleRate, blockSize, isa);
+
+						//༭̺߳ͺ̨߳£ڻص
+						float indB, outdB, thdB, reddB;
+						limiter->GetMeterValues(indB, outdB, thdB, reddB);
+						loudness->Update();
+					}
+				}
+			}
+		}
+		delete loudness;
+		delete limiter;
+	}
+
+	void RunBatch()
+	{
+		constexpr int Lanes = 8;
+		LMLimiterBatch<Lanes>* batch = new LMLimiterBatch<Lanes>();
+		std::vector<float> bufL(Lanes * MaxBlockSize), bufR(Lanes * MaxBlockSize);
+		const float* inL[Lanes];
+		const float* inR[Lanes];
+		float* outL[Lanes];
+		float* outR[Lanes];
+		Rng rng;
+		double phase = 0;
+
+		for (double sampleRate : SampleRates)
+		{
+			for (int blockSize : BlockSizes)
+			{
+				batch->SetSampleRate((float)sampleRate);
+				batch->Reset();
+				const int numBlocks = NumBlocks(sampleRate, blockSize);
+				for (int b = 0; b < numBlocks; ++b)
+				{
+					for (int k = 0; k < Lanes; ++k)
+					{
+						float* l = bufL.data() + k * MaxBlockSize;
+						float* r = bufR.data() + k * MaxBlockSize;
+						FillSignal(rng, l, r, blockSize, phase, sampleRate);
+						bool idle = k == 3 && b % 2 == 1;//еһ· nullptr
+						inL[k] = idle ? nullptr : l;
+						inR[k] = idle ? nullptr : r;
+						outL[k] = idle ? nullptr : l;
+						outR[k] = idle ? nullptr : r;
+					}
+					const float lookahead = rng.Uniform(0, 20);
+					{
+						LMRt::Scope scope;
+						if (b % 8 == 0) batch->SetLookahead(lookahead);
+						for (int k = 0; k < Lanes; ++k)
+							batch->SetLaneParams(k, rng.Uniform(-30, 30), rng.Uniform(-30, 30), rng.Uniform(-30, 30),
+								rng.Uniform(0, 500), rng.Uniform(4, 500));
+						batch->ProcessBlock(inL, inR, outL, outR, blockSize);
+					}
+					Check("LMLimiterBatch", sampleRate, blockSize, 0);
+				}
+			}
+		}
+		delete batch;
+	}
+
+	void RunCApi()
+	{
+		const size_t align = lmlimiter_instance_alignment();
+		const size_t size = (lmlimiter_instance_size() + align - 1) / align * align;
+		void* mem = aligned_alloc(align, size);
+		lmlimiter* lim = lmlimiter_create(mem, size);
+		std::vector<float> l(MaxBlockSize), r(MaxBlockSize), interleaved(MaxBlockSize * 2);
+		Rng rng;
+		double phase = 0;
+
+		for (double sampleRate : SampleRates)
+		{
+			if (lmlimiter_prepare(lim, sampleRate) != 0) continue;
+			for (int blockSize : BlockSizes)
+			{
+				const int numBlocks = NumBlocks(sampleRate, blockSize);
+				for (int b = 0; b < numBlocks; ++b)
+				{
+					FillSignal(rng, l.data(), r.data(), blockSize, phase, sampleRate);
+					for (int i = 0; i < blockSize; ++i)
+					{
+						interleaved[i * 2] = l[i];
+						interleaved[i * 2 + 1] = r[i];
+					}
+					const float* in[2] = { l.data(), r.data() };
+					float* out[2] = { l.data(), r.data() };
+					const float lookahead = rng.Uniform(0, 20), threshold = rng.Uniform(-30, 0), release = rng.Uniform(4, 500);
+					{
+						LMRt::Scope scope;
+						if (b % 8 == 0) lmlimiter_set_param(lim, LMLIMITER_PARAM_LOOKAHEAD_MS, lookahead);
+						lmlimiter_set_param(lim, LMLIMITER_PARAM_THRESHOLD_DB, threshold);
+						lmlimiter_set_param(lim, LMLIMITER_PARAM_RELEASE_MS, release);
+						lmlimiter_process_planar(lim, in, out, b % 3 == 0 ? 1 : 2, blockSize);
+						lmlimiter_process_interleaved(lim, interleaved.data(), interleaved.data(), 2, blockSize);
+					}
+					Check("C API", sampleRate, blockSize, 0);
+				}
+			}
+		}
+		lmlimiter_destroy(lim);
+		free(mem);
+	}
+}
+
+int main()
+{
+	if (!LMRt::SelfTest())
+	{
+		printf("FAIL allocation/lock interposers are not active in this build\n");
+		return 1;
+	}
+#if LMLIMITER_TRACE
+	LMTrace::GetThreadRing();//ٹÿ̵߳һμ¼ʱ컷λ壬һβڻص
+#endif
+
+	RunLimiter();
+	RunBatch();
+	RunCApi();
+
+	if (failures)
+	{
+		printf("%d callbacks allocated or locked\n", failures);
+		return 1;
+	}
+	printf("no allocations or locks inside the audio callback\n");
+	return 0;
+}
@@ -0,0 +1,116 @@
+/*
+lmlimiter_rtsafety_plugin:  lmlimiter_rtsafety һļ飬󻻳ɲ LModelAudioProcessor::processBlock
+ߴ򿪣 4 ͨ"Ϣ߳"̣߳дprocessBlock  LMRt::Scope ܣ
+ɨʡ鳤lookaheadм䴩Ԥ衣prepareToPlay/releaseResources ڻص
+ֻҵ JUCE ʱ룬ӲĹĿ
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+#include "lmrtguard.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+namespace
+{
+	struct Rng
+	{
+		uint32_t state = 12345;
+		uint32_t NextU32()
+		{
+			state = state * 1664525u + 1013904223u;
+			return state;
+		}
+		float Uniform01() { return (NextU32() >> 8) * (1.0f / 16777216.0f); }
+		bool Chance(int oneIn) { return NextU32() % (uint32_t)oneIn == 0; }
+	};
+
+	const char* const ContinuousParams[] = { "attack", "release", "input", "output", "threshold", "adaptive",
+		"levelthr", "levelatt", "levelrel", "clipknee", "midthr", "sidethr" };
+	const char* const SwitchParams[] = { "smooth", "economy", "twostage", "sidechain", "midside" };
+
+	const double SampleRates[] = { 22050, 44100, 48000, 96000, 192000 };
+	const int BlockSizes[] = { 1, 17, 64, 100, 256, 512, 1000, 4096 };
+
+	int failures = 0;
+
+	void Check(double sampleRate, int blockSize)
+	{
+		if (LMRt::GetTotal() == 0) return;
+		if (++failures <= 20)
+		{
+			printf("FAIL processBlock (%.0f Hz, block %d):", sampleRate, blockSize);
+			for (int k = 0; k < LMRt::NumKinds; ++k)
+				if (LMRt::GetCount(k)) printf(" %s x%lld", LMRt::KindName(k), LMRt::GetCount(k));
+			printf("\n");
+		}
+		LMRt::ResetCounts();
+	}
+}
+
+int main()
+{
+	juce::ScopedJuceInitialiser_GUI juceInit;
+	if (!LMRt::SelfTest())
+	{
+		printf("FAIL allocation/lock interposers are not active in this build\n");
+		return 1;
+	}
+
+	auto processor = std::make_unique<LModelAudioProcessor>();
+	auto layout = processor->getBusesLayout();
+	layout.inputBuses.getReference(1) = juce::AudioChannelSet::stereo();
+	if (!processor->setBusesLayout(layout))
+	{
+		printf("FAIL can't enable the sidechain bus\n");
+		return 1;
+	}
+	auto& params = processor->GetParams();
+	Rng rng;
+
+	for (double sampleRate : SampleRates)
+	{
+		for (int blockSize : BlockSizes)
+		{
+			processor->setRateAndBufferSizeDetails(sampleRate, blockSize);
+			processor->prepareToPlay(sampleRate, blockSize);
+			juce::AudioBuffer<float> buffer(processor->getTotalNumInputChannels(), blockSize);
+			juce::MidiBuffer midi;
+
+			int numBlocks = (int)(sampleRate * 0.25 / blockSize);
+			if (numBlocks < 48) numBlocks = 48;
+			for (int b = 0; b < numBlocks; ++b)
+			{
+				for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+				{
+					float* x = buffer.getWritePointer(ch);
+					for (int i = 0; i < blockSize; ++i) x[i] = (rng.Uniform01() * 2.0f - 1.0f) * (b % 4 < 2 ? 1.5f : 0.2f);
+				}
+
+				//Զÿ鶼䣬żУlookahead һΣżԤ
+				for (const char* id : ContinuousParams)
+					params.getParameter(id)->setValueNotifyingHost(rng.Uniform01());
+				for (const char* id : SwitchParams)
+					if (rng.Chance(16)) params.getParameter(id)->setValueNotifyingHost(rng.Uniform01());
+				if (b % 8 == 0) params.getParameter("lookahead")->setValueNotifyingHost(rng.Uniform01());
+				if (rng.Chance(32)) processor->setCurrentProgram((int)(rng.NextU32() % LModelAudioProcessor::NumPresets));
+
+				{
+					LMRt::Scope scope;
+					processor->processBlock(buffer, midi);
+				}
+				Check(sampleRate, blockSize);
+			}
+			processor->releaseResources();
+		}
+	}
+
+	if (failures)
+	{
+		printf("%d processBlock calls allocated or locked\n", failures);
+		return 1;
+	}
+	printf("no allocations or locks inside processBlock\n");
+	return 0;
+}
@@ -0,0 +1,178 @@
+/*
+lmlimiter_scheduler: LMScheduler Ĺܼ
+	1. N ·  M ֣ÿÿ·Ͷһ LMLimiter 飺ÿִһΣWaitIdle ܷأ
+	   GetStats().completed Ͷݵ
+	2. ȫͶݸ 0 ̣̻߳߳ȥ͵steals > 0deadline Ѿ˵ȫ miss
+	3. ͳǢp50 <= p99 <= p999 <= maxmissessteals  completed
+	4. ʱ Submit  false֮ܵȫִ
+κһ㷵 1
+*/
+
+#include "../host/lmscheduler.h"
+
+#include <math.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+namespace
+{
+	constexpr int NumStreams = 24;
+	constexpr int NumRounds = 200;
+	constexpr int BlockSize = 256;
+
+	int failures = 0;
+
+	void Fail(const char* fmt, ...)
+	{
+		if (++failures > 40) return;
+		va_list args;
+		va_start(args, fmt);
+		printf("FAIL: ");
+		vprintf(fmt, args);
+		printf("\n");
+		va_end(args);
+	}
+
+	//һ񣺼ִдһ
+	struct CountedJob
+	{
+		std::atomic<int> runs{ 0 };
+		LMLimiterStreamJob block;
+
+		static void Run(void* context)
+		{
+			CountedJob* job = static_cast<CountedJob*>(context);
+			job->runs.fetch_add(1, std::memory_order_relaxed);
+			LMLimiterStreamJob::Run(&job->block);
+		}
+	};
+
+	struct Stream
+	{
+		LMLimiter limiter;
+		std::vector<float> l, r;
+	};
+
+	void CheckStats(const char* what, const LMScheduler::Stats& st, uint64_t submitted)
+	{
+		printf("%-10s completed %llu  steals %llu  misses %llu  p50 %llu  p99 %llu  p999 %llu  max %llu ns\n", what,
+			(unsigned long long)st.completed, (unsigned long long)st.steals, (unsigned long long)st.deadlineMisses,
+			(unsigned long long)st.p50Ns, (unsigned long long)st.p99Ns, (unsigned long long)st.p999Ns, (unsigned long long)st.maxNs);
+		if (st.completed != submitted)
+			Fail("%s: completed %llu, submitted %llu", what, (unsigned long long)st.completed, (unsigned long long)submitted);
+		if (st.steals > st.completed) Fail("%s: more steals than jobs", what);
+		if (st.deadlineMisses > st.completed) Fail("%s: more deadline misses than jobs", what);
+		if (!(st.p50Ns <= st.p99Ns && st.p99Ns <= st.p999Ns && st.p999Ns <= st.maxNs))
+			Fail("%s: percentiles out of order", what);
+		if (submitted > 0 && st.maxNs == 0) Fail("%s: no latency recorded", what);
+	}
+
+	//ÿÿ·Ͷһ飬֮ WaitIdleͬһ limiter ͬʱ飩
+	//preferAll0ȫͶ 0 ̣߳latedeadline Ѿ
+	void RunRounds(LMScheduler& sched, std::vector<Stream>& streams, bool preferAll0, bool late, const char* what)
+	{
+		std::vector<CountedJob> jobs(NumStreams * NumRounds);
+		sched.ResetStats();
+		uint64_t submitted = 0;
+		for (int round = 0; round < NumRounds; ++round)
+		{
+			const int64_t deadline = late ? LMScheduler::NowNs() - 1 : LMScheduler::NowNs() + 1000000000;
+			for (int k = 0; k < NumStreams; ++k)
+			{
+				Stream& st = streams[k];
+				CountedJob& job = jobs[round * NumStreams + k];
+				job.block = { &st.limiter, st.l.data(), st.r.data(), st.l.data(), st.r.data(), BlockSize };
+				if (!sched.Submit(CountedJob::Run, &job, deadline, preferAll0 ? 0 : k))
+					Fail("%s: Submit rejected job %d of round %d", what, k, round);
+				else
+					++submitted;
+			}
+			sched.WaitIdle();
+		}
+
+		int wrong = 0;
+		for (CountedJob& job : jobs)
+			if (job.runs.load() != 1 && ++wrong <= 5) Fail("%s: a job ran %d times", what, job.runs.load());
+		const LMScheduler::Stats stats = sched.GetStats();
+		CheckStats(what, stats, submitted);
+		if (late && stats.deadlineMisses != submitted)
+			Fail("%s: %llu misses, every one of the %llu jobs was late", what,
+				(unsigned long long)stats.deadlineMisses, (unsigned long long)submitted);
+		if (preferAll0 && sched.GetNumWorkers() > 1 && stats.steals == 0)
+			Fail("%s: all jobs went to worker 0 and nothing was stolen", what);
+	}
+
+	//һ̡߳ 4һס̣߳Ժ Submit  false
+	struct BlockingJob
+	{
+		std::atomic<bool> release{ false };
+		std::atomic<int> runs{ 0 };
+		static void Run(void* context)
+		{
+			BlockingJob* job = static_cast<BlockingJob*>(context);
+			while (!job->release.load()) std::this_thread::yield();
+			job->runs.fetch_add(1);
+		}
+	};
+
+	void CheckQueueFull()
+	{
+		LMScheduler::Options options;
+		options.numWorkers = 1;
+		options.queueCapacity = 4;
+		LMScheduler sched(options);
+		std::vector<BlockingJob> jobs(64);
+		int accepted = 0;
+		bool rejected = false;
+		for (BlockingJob& job : jobs)
+		{
+			if (!sched.Submit(BlockingJob::Run, &job, LMScheduler::NowNs() + 1000000000))
+			{
+				rejected = true;
+				break;
+			}
+			++accepted;
+		}
+		if (!rejected) Fail("queue full: Submit never returned false");
+		if (accepted > options.queueCapacity + 1) Fail("queue full: accepted %d jobs with capacity %d", accepted, options.queueCapacity);
+		for (BlockingJob& job : jobs) job.release.store(true);
+		sched.WaitIdle();
+		int ran = 0;
+		for (BlockingJob& job : jobs) ran += job.runs.load();
+		if (ran != accepted) Fail("queue full: %d jobs ran, %d accepted", ran, accepted);
+		CheckStats("queue full", sched.GetStats(), (uint64_t)accepted);
+	}
+}
+
+int main()
+{
+	std::vector<Stream> streams(NumStreams);
+	for (int k = 0; k < NumStreams; ++k)
+	{
+		Stream& st = streams[k];
+		st.limiter.SetSampleRate(48000.0f);
+		st.limiter.SetParams(5, 6, 0, -3, 1, 30);
+		st.l.resize(BlockSize);
+		st.r.resize(BlockSize);
+		for (int i = 0; i < BlockSize; ++i)
+		{
+			st.l[i] = (float)sin(0.05 * (i + 1) * (k + 1));
+			st.r[i] = (float)cos(0.03 * (i + 1) * (k + 1));
+		}
+	}
+
+	LMScheduler::Options options;
+	options.numWorkers = 4;
+	LMScheduler sched(options);
+	printf("%d workers, %d streams x %d rounds\n", sched.GetNumWorkers(), NumStreams, NumRounds);
+	RunRounds(sched, streams, false, false, "spread");
+	RunRounds(sched, streams, true, false, "worker 0");
+	RunRounds(sched, streams, false, true, "late");
+	CheckQueueFull();
+
+	if (failures) printf("%d failure(s)\n", failures);
+	else printf("all scheduler checks passed\n");
+	return failures ? 1 : 0;
+}
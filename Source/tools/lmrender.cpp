@@ -0,0 +1,329 @@
+/*
+lmlimiter_render: ȾJUCE
+	lmlimiter_render in.wav out.wav [--lookahead ms] [--attack ms] [--release ms]
+		[--input dB] [--output dB] [--threshold dB] [--adaptive %] [--smooth 0|1] [--economy N]
+		[--twostage 0|1] [--levelthr dB] [--levelatt ms] [--levelrel ms] [--clipknee dB]
+		[--midside 0|1] [--midthr dB] [--sidethr dB] [--sidechain key.wav] [--isa name] [--block N] [--trace out.json]
+ 16/24/32λPCM  32λ WAV/д 32λ WAV
+--sidechain ˾⣨߹ã˲㣩Ҫһ
+--isa ǿ scalar/sse2/avx2/avx512 ںˣĬϰ CPU ѡ LMLIMITER_ISA ҲУԱȿ
+ӡõں˺ĺʱʵʱ
+Ѿʱ룻ӡ BS.1770 
+*/
+
+#include "../dsp/lmlimiter.h"
+#include "../dsp/lmloudness.h"
+#include "../dsp/lmtrace.h"
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+	struct WavData
+	{
+		int numChannels = 0;
+		int sampleRate = 0;
+		std::vector<float> samples;//
+	};
+
+	uint32_t ReadU32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+	uint16_t ReadU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+	bool ReadWav(const char* path, WavData& wav)
+	{
+		FILE* f = fopen(path, "rb");
+		if (!f) return false;
+		std::vector<uint8_t> file;
+		uint8_t tmp[65536];
+		size_t n;
+		while ((n = fread(tmp, 1, sizeof(tmp), f)) > 0) file.insert(file.end(), tmp, tmp + n);
+		fclose(f);
+
+		if (file.size() < 12 || memcmp(file.data(), "RIFF", 4) != 0 || memcmp(file.data() + 8, "WAVE", 4) != 0) return false;
+
+		int format = 0, bits = 0;
+		const uint8_t* data = nullptr;
+		size_t dataSize = 0;
+		for (size_t pos = 12; pos + 8 <= file.size();)
+		{
+			const uint8_t* chunk = file.data() + pos;
+			size_t size = ReadU32(chunk + 4);
+			if (pos + 8 + size > file.size()) size = file.size() - pos - 8;
+			if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+			{
+				format = ReadU16(chunk + 8);
+				wav.numChannels = ReadU16(chunk + 10);
+				wav.sampleRate = (int)ReadU32(chunk + 12);
+				bits = ReadU16(chunk + 22);
+				if (format == 0xFFFE && size >= 26) format = ReadU16(chunk + 32);//WAVE_FORMAT_EXTENSIBLE Ӹʽ
+			}
+			else if (memcmp(chunk, "data", 4) == 0)
+			{
+				data = chunk + 8;
+				dataSize = size;
+			}
+			pos += 8 + size + (size & 1);
+		}
+		if (!data || wav.numChannels < 1 || wav.numChannels > 2) return false;
+
+		const int bytes = bits / 8;
+		if (!((format == 1 && (bits == 16 || bits == 24 || bits == 32)) || (format == 3 && bits == 32))) return false;
+		size_t count = dataSize / bytes;
+		wav.samples.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			const uint8_t* p = data + i * bytes;
+			if (format == 3)
+			{
+				uint32_t u = ReadU32(p);
+				memcpy(&wav.samples[i], &u, 4);
+			}
+			else if (bits == 16) wav.samples[i] = (int16_t)ReadU16(p) / 32768.0f;
+			else if (bits == 24) wav.samples[i] = (int32_t)((uint32_t)(p[0] << 8 | p[1] << 16 | p[2] << 24)) / 2147483648.0f;
+			else wav.samples[i] = (int32_t)ReadU32(p) / 2147483648.0f;
+		}
+		return true;
+	}
+
+	void WriteU32(FILE* f, uint32_t v) { uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) }; fwrite(b, 1, 4, f); }
+	void WriteU16(FILE* f, uint16_t v) { uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) }; fwrite(b, 1, 2, f); }
+
+	bool WriteWav(const char* path, const WavData& wav)
+	{
+		FILE* f = fopen(path, "wb");
+		if (!f) return false;
+		uint32_t dataSize = (uint32_t)(wav.samples.size() * 4);
+		fwrite("RIFF", 1, 4, f);
+		WriteU32(f, 36 + dataSize);
+		fwrite("WAVEfmt ", 1, 8, f);
+		WriteU32(f, 16);
+		WriteU16(f, 3);//IEEE float
+		WriteU16(f, (uint16_t)wav.numChannels);
+		WriteU32(f, (uint32_t)wav.sampleRate);
+		WriteU32(f, (uint32_t)(wav.sampleRate * wav.numChannels * 4));
+		WriteU16(f, (uint16_t)(wav.numChannels * 4));
+		WriteU16(f, 32);
+		fwrite("data", 1, 4, f);
+		WriteU32(f, dataSize);
+		for (float s : wav.samples)
+		{
+			uint32_t u;
+			memcpy(&u, &s, 4);
+			WriteU32(f, u);
+		}
+		bool ok = ferror(f) == 0;
+		fclose(f);
+		return ok;
+	}
+
+	void PrintUsage()
+	{
+		fprintf(stderr,
+			"usage: lmlimiter_render in.wav out.wav [--lookahead ms] [--attack ms] [--release ms]\n"
+			"                        [--input dB] [--output dB] [--threshold dB] [--adaptive %%] [--smooth 0|1] [--economy N]\n"
+			"                        [--twostage 0|1] [--levelthr dB] [--levelatt ms] [--levelrel ms] [--clipknee dB]\n"
+			"                        [--midside 0|1] [--midthr dB] [--sidethr dB] [--sidechain key.wav]\n"
+			"                        [--isa scalar|sse2|avx2|avx512] [--block N]"
+#if LMLIMITER_TRACE
+			" [--trace out.json]"
+#endif
+			"\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	//ĬֵͲһ
+	float lookahead = 5, attack = 1, release = 10, inputdB = 0, outputdB = 0, thresholddB = 0, adaptive = 0;
+	int blockSize = 512;
+	bool smooth = false;
+	int economy = 1;
+	bool twoStage = false;
+	float levelThreshold = -3, levelAttack = 30, levelRelease = 300;
+	float clipKnee = 0;
+	const char* sidechainPath = nullptr;
+	bool midSide = false;
+	float midThreshold = 0, sideThreshold = 0;
+	const char* isaName = nullptr;
+	const char* tracePath = nullptr;
+	for (int i = 3; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (i + 1 >= argc)
+		{
+			PrintUsage();
+			return 1;
+		}
+		const char* value = argv[++i];
+		if (arg == "--lookahead") lookahead = (float)atof(value);
+		else if (arg == "--attack") attack = (float)atof(value);
+		else if (arg == "--release") release = (float)atof(value);
+		else if (arg == "--input") inputdB = (float)atof(value);
+		else if (arg == "--output") outputdB = (float)atof(value);
+		else if (arg == "--threshold") thresholddB = (float)atof(value);
+		else if (arg == "--adaptive") adaptive = (float)atof(value);
+		else if (arg == "--smooth") smooth = atoi(value) != 0;
+		else if (arg == "--economy") economy = atoi(value);
+		else if (arg == "--twostage") twoStage = atoi(value) != 0;
+		else if (arg == "--levelthr") levelThreshold = (float)atof(value);
+		else if (arg == "--levelatt") levelAttack = (float)atof(value);
+		else if (arg == "--levelrel") levelRelease = (float)atof(value);
+		else if (arg == "--clipknee") clipKnee = (float)atof(value);
+		else if (arg == "--sidechain") sidechainPath = value;
+		else if (arg == "--midside") midSide = atoi(value) != 0;
+		else if (arg == "--midthr") midThreshold = (float)atof(value);
+		else if (arg == "--sidethr") sideThreshold = (float)atof(value);
+		else if (arg == "--isa") isaName = value;
+		else if (arg == "--block") blockSize = atoi(value);
+		else if (arg == "--trace") tracePath = value;
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+	if (blockSize < 1) blockSize = 1;
+
+	WavData in;
+	if (!ReadWav(argv[1], in))
+	{
+		fprintf(stderr, "can't read %s (need 16/24/32-bit PCM or 32-bit float, mono or stereo)\n", argv[1]);
+		return 1;
+	}
+
+	WavData key;
+	if (sidechainPath)
+	{
+		if (!ReadWav(sidechainPath, key))
+		{
+			fprintf(stderr, "can't read %s (need 16/24/32-bit PCM or 32-bit float, mono or stereo)\n", sidechainPath);
+			return 1;
+		}
+		if (key.sampleRate != in.sampleRate)
+		{
+			fprintf(stderr, "%s: sample rate %d doesn't match the input (%d)\n", sidechainPath, key.sampleRate, in.sampleRate);
+			return 1;
+		}
+	}
+
+	using LMLimiterNamespace::cpu::Isa;
+	Isa requestedIsa = Isa::Scalar;
+	if (isaName && !LMLimiterNamespace::cpu::ParseIsa(isaName, requestedIsa))
+	{
+		PrintUsage();
+		return 1;
+	}
+	const Isa isa = LMLimiterNamespace::cpu::SelectIsa(isaName);
+	if (isaName && requestedIsa != isa)
+		fprintf(stderr, "--isa %s: not supported by this CPU, using %s\n", isaName, LMLimiterNamespace::cpu::IsaName(isa));
+
+	LMLimiter* limiter = new LMLimiter();//״̬Ƚϴ󣬲ջ
+	limiter->SetIsa(isa);
+	limiter->SetSampleRate((float)in.sampleRate);
+	limiter->SetParams(lookahead, inputdB, outputdB, thresholddB, attack, release);
+	limiter->SetAdaptiveRelease(adaptive / 100.0f);
+	limiter->SetSmoothAttack(smooth);
+	limiter->SetEconomy(economy);
+	limiter->SetLeveler(twoStage, levelThreshold, levelAttack, levelRelease);
+	limiter->SetClipKnee(clipKnee);
+	limiter->SetMidSide(midSide, midThreshold, sideThreshold);
+	limiter->Reset();
+	const int latency = limiter->GetLatencySamples();
+
+	const int ch = in.numChannels;
+	const size_t numFrames = in.samples.size() / ch;
+	const size_t totalFrames = numFrames + latency;//ĩβʱ
+
+	WavData out;
+	out.numChannels = ch;
+	out.sampleRate = in.sampleRate;
+	out.samples.assign(numFrames * ch, 0.0f);
+
+	LMLoudnessMeter loudness;
+	loudness.SetSampleRate((float)in.sampleRate);
+
+	const size_t keyFrames = sidechainPath ? key.samples.size() / key.numChannels : 0;
+	std::vector<float> l(blockSize), r(blockSize), silence(blockSize, 0.0f);
+	std::vector<float> kl(sidechainPath ? blockSize : 0), kr(sidechainPath ? blockSize : 0);
+	float maxReductiondB = 0;
+	std::chrono::steady_clock::duration limiterTime{};
+	for (size_t start = 0; start < totalFrames; start += blockSize)
+	{
+		int n = (int)(totalFrames - start < (size_t)blockSize ? totalFrames - start : blockSize);
+		for (int i = 0; i < n; ++i)
+		{
+			size_t frame = start + i;
+			l[i] = frame < numFrames ? in.samples[frame * ch] : 0.0f;
+			r[i] = frame < numFrames ? in.samples[frame * ch + ch - 1] : 0.0f;
+		}
+		for (int i = 0; i < (int)kl.size() && i < n; ++i)
+		{
+			size_t frame = start + i;
+			kl[i] = frame < keyFrames ? key.samples[frame * key.numChannels] : 0.0f;
+			kr[i] = frame < keyFrames ? key.samples[frame * key.numChannels + key.numChannels - 1] : 0.0f;
+		}
+
+		limiter->SetParams(lookahead, inputdB, outputdB, thresholddB, attack, release);
+		auto t0 = std::chrono::steady_clock::now();
+		limiter->ProcessBlock(l.data(), r.data(), l.data(), r.data(), n,
+			sidechainPath ? kl.data() : nullptr, sidechainPath ? kr.data() : nullptr);
+		limiterTime += std::chrono::steady_clock::now() - t0;
+
+		for (int i = 0; i < n; ++i)
+		{
+			if (start + i < (size_t)latency) continue;
+			size_t frame = start + i - latency;
+			out.samples[frame * ch] = l[i];
+			if (ch == 2) out.samples[frame * ch + 1] = r[i];
+		}
+
+		//ֻ㲹ʱǲ֣ʱιȻ 3dB
+		int skip = start < (size_t)latency ? (int)((size_t)latency - start < (size_t)n ? latency - start : n) : 0;
+		loudness.ProcessBlock(l.data() + skip, ch == 2 ? r.data() + skip : silence.data(), n - skip);
+		loudness.Update();
+
+#if WithEditor
+		float indB, outdB, thdB, reddB;
+		limiter->GetMeterValues(indB, outdB, thdB, reddB);
+		if (reddB > maxReductiondB) maxReductiondB = reddB;
+#endif
+	}
+	delete limiter;
+
+	if (!WriteWav(argv[2], out))
+	{
+		fprintf(stderr, "can't write %s\n", argv[2]);
+		return 1;
+	}
+	printf("%s: %zu frames, %d ch, %d Hz, latency %d samples, max gain reduction %.2f dB\n",
+		argv[2], numFrames, ch, in.sampleRate, latency, maxReductiondB);
+	auto lufs = loudness.GetValues();
+	printf("loudness: integrated %.1f LUFS, range %.1f LU, max momentary %.1f LUFS, max short-term %.1f LUFS\n",
+		lufs.integrated, lufs.range, lufs.maxMomentary, lufs.maxShortTerm);
+	const double seconds = std::chrono::duration<double>(limiterTime).count();
+	printf("kernels: %s (cpu supports %s), limiter %.2f ms, %.0fx realtime\n",
+		LMLimiterNamespace::cpu::IsaName(isa), LMLimiterNamespace::cpu::IsaName(LMLimiterNamespace::cpu::DetectIsa()),
+		seconds * 1000.0, seconds > 0 ? (double)totalFrames / in.sampleRate / seconds : 0.0);
+
+	if (tracePath)
+	{
+#if LMLIMITER_TRACE
+		if (!LMTrace::WriteChromeJson(tracePath)) fprintf(stderr, "can't write %s\n", tracePath);
+#else
+		fprintf(stderr, "--trace ignored: built without LMLIMITER_TRACE\n");
+#endif
+	}
+	return 0;
+}
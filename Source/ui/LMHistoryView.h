@@ -0,0 +1,105 @@
+#pragma once
+
+#include "../dsp/lmlimiter.h"
+#include <JuceHeader.h>
+
+// ʷͼ/ΰ + ѹ
+// Ƶ̳߳ȡõժҪλȡÿ֡ѻͼֻµУ
+// ֻйأʷ޹
+class LMHistoryView : public juce::Component
+{
+private:
+	static constexpr int MaxFramesPerUpdate = 256;
+
+	LMLimiter* limiter = nullptr;
+	LMHistoryFrame frames[MaxFramesPerUpdate];
+
+	juce::Image image;//ش
+	float imageScale = 0.0f;
+	int columnPx = 1;//ÿռ
+
+	const juce::Colour backgroundColor = juce::Colour(0xff222222);
+	const juce::Colour inputColor = juce::Colour(0xff00aaff).withAlpha(0.5f);
+	const juce::Colour outputColor = juce::Colour(0xffff8800).withAlpha(0.8f);
+	const juce::Colour reductionColor = juce::Colour(0xffff4444).withAlpha(0.8f);
+	const float reductionRangedB = 24.0f;//ѹ̶
+
+	void RebuildImage(float scale)
+	{
+		imageScale = scale;
+		columnPx = juce::jmax(1, juce::roundToInt(scale));
+		int iw = juce::roundToInt(getWidth() * scale), ih = juce::roundToInt(getHeight() * scale);
+		if (iw <= 0 || ih <= 0)
+		{
+			image = juce::Image();
+			return;
+		}
+		image = juce::Image(juce::Image::RGB, iw, ih, false);
+		image.clear(image.getBounds(), backgroundColor);
+	}
+
+	void DrawColumn(juce::Graphics& ig, int x, int ih, const LMHistoryFrame& f)
+	{
+		float mid = ih * 0.5f;
+		auto toY = [mid](float v) { return mid - juce::jlimit(-1.0f, 1.0f, v) * mid; };
+
+		ig.setColour(inputColor);
+		ig.fillRect(juce::Rectangle<float>((float)x, toY(f.inMax), (float)columnPx, juce::jmax(1.0f, toY(f.inMin) - toY(f.inMax))));
+		ig.setColour(outputColor);
+		ig.fillRect(juce::Rectangle<float>((float)x, toY(f.outMax), (float)columnPx, juce::jmax(1.0f, toY(f.outMin) - toY(f.outMax))));
+
+		float reductiondB = LMLimiterNamespace::GainToDb(1.0f + f.gainAdd);
+		if (reductiondB > 0.01f)
+		{
+			ig.setColour(reductionColor);
+			ig.fillRect(juce::Rectangle<float>((float)x, 0.0f, (float)columnPx, juce::jmin(1.0f, reductiondB / reductionRangedB) * ih));
+		}
+	}
+
+public:
+	LMHistoryView(LMLimiter* limiter) : limiter(limiter)
+	{
+		setOpaque(true);
+		if (limiter) limiter->GetHistory().Drain();//༭ûʱѹľݲҪ
+	}
+
+	// ɱ༭ÿʾ֡
+	void UpdateFrame()
+	{
+		if (!limiter) return;
+		int n = limiter->GetHistory().Pop(frames, MaxFramesPerUpdate);
+
+		float scale = juce::Component::getApproximateScaleFactorForComponent(this);
+		if (scale != imageScale) RebuildImage(scale);//ߴ仯 resized ﴦ
+		if (n == 0 || !image.isValid() || !isVisible()) return;
+
+		int iw = image.getWidth(), ih = image.getHeight();
+		int first = juce::jmax(0, n - iw / columnPx);//ͼĲֱ
+		int shift = (n - first) * columnPx;
+		if (shift < iw) image.moveImageSection(0, 0, shift, 0, iw - shift, ih);
+		else shift = iw;
+
+		juce::Graphics ig(image);
+		ig.setColour(backgroundColor);
+		ig.fillRect(iw - shift, 0, shift, ih);
+		for (int i = first; i < n; ++i)
+			DrawColumn(ig, iw - (n - i) * columnPx, ih, frames[i]);
+
+		repaint();
+	}
+
+	void paint(juce::Graphics& g) override
+	{
+		if (!image.isValid())
+		{
+			g.fillAll(backgroundColor);
+			return;
+		}
+		g.drawImageTransformed(image, juce::AffineTransform::scale(1.0f / imageScale));
+	}
+
+	void resized() override
+	{
+		RebuildImage(juce::Component::getApproximateScaleFactorForComponent(this));
+	}
+};
@@ -37,6 +37,15 @@ public:
 		reductionMeter.SetValueAndRange(60 - reductiondB, 0, 60);
 		outputMeter.SetValueAndRange(outputdB, -30, 30);
 	}
+	//ɱ༭ÿʾ֡ãȡһDSPĵƽֻػ仯Ĳ
+	void UpdateFrame()
+	{
+		updateMeters();
+		auto now = (juce::int64)juce::Time::getMillisecondCounter();
+		inputMeter.AdvanceFrame(now);
+		reductionMeter.AdvanceFrame(now);
+		outputMeter.AdvanceFrame(now);
+	}
 	void paint(juce::Graphics& g) override
 	{
 		int w = getWidth();
@@ -44,7 +53,6 @@ public:
 		int interval = w / 8;
 		int metalWidth = w / 4;
 
-		updateMeters();
 		/*
 		g.setColour(juce::Colour(0xff00ff00));
 		g.setFont(juce::Font("FIXEDSYS", 12.0, 1));
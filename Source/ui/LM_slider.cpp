@@ -6,14 +6,36 @@ void L_MODEL_STYLE::drawLinearSlider(juce::Graphics& g, int x, int y, int width,
 
 void L_MODEL_STYLE::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPosProportional, float rotaryStartAngle, float rotaryEndAngle, juce::Slider& slider)
 {
-	juce::Path arcPath1, arcPath2;
 	float zoomVal = 0.55;//·Å´óÏµÊý
-	arcPath1.addArc(x + width * (1.0 - zoomVal) / 2.0, y + height * (1.0 - zoomVal) / 2.0 - 4, width * zoomVal, height * zoomVal, M_PI / 4 - M_PI, M_PI / 4 - M_PI + sliderPosProportional * M_PI * 1.5, true);
-	arcPath2.addArc(x + width * (1.0 - zoomVal) / 2.0, y + height * (1.0 - zoomVal) / 2.0 - 4, width * zoomVal, height * zoomVal, M_PI / 4 - M_PI + sliderPosProportional * M_PI * 1.5, -M_PI / 4 + M_PI, true);
+	float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+	juce::Rectangle<int> bounds(x, y, width, height);
+	if (knobTrackImage.isNull() || knobTrackBounds != bounds || knobTrackScale != scale)
+	{
+		//Ö»ÔÚ³ß´ç»òËõ·Å±ä»¯Ê±ÖØ»­Ò»´ÎÕûÈ¦µÄ°µÉ«¹ìµÀ
+		knobTrackBounds = bounds;
+		knobTrackScale = scale;
+		knobTrackImage = juce::Image(juce::Image::ARGB, juce::jmax(1, juce::roundToInt(width * scale)), juce::jmax(1, juce::roundToInt(height * scale)), true);
+		juce::Graphics ig(knobTrackImage);
+		ig.addTransform(juce::AffineTransform::scale(scale));
+		juce::Path trackPath;
+		trackPath.addArc(width * (1.0 - zoomVal) / 2.0, height * (1.0 - zoomVal) / 2.0 - 4, width * zoomVal, height * zoomVal, M_PI / 4 - M_PI, -M_PI / 4 + M_PI, true);
+		ig.setColour(juce::Colour(0x33, 0x33, 0x66));
+		ig.strokePath(trackPath, juce::PathStrokeType(4.0));//»æÖÆ£¬ÕâÀï²ÅÊÇÉèÖÃÏß¿í
+		knobValuePos = -1.0f;
+	}
+	g.drawImageTransformed(knobTrackImage, juce::AffineTransform::scale(1.0f / scale).translated((float)x, (float)y));
+
+	if (knobValuePos != sliderPosProportional)
+	{
+		//ÊýÖµ»¡ÏßÖ»ÔÚÐýÅ¥×ª¶¯Ê±²Å±ä£¬°ÑÃè±ßºóµÄÂÖÀªÁô×Å¸ø fillPath ÓÃ
+		knobValuePos = sliderPosProportional;
+		juce::Path arcPath1;
+		arcPath1.addArc(x + width * (1.0 - zoomVal) / 2.0, y + height * (1.0 - zoomVal) / 2.0 - 4, width * zoomVal, height * zoomVal, M_PI / 4 - M_PI, M_PI / 4 - M_PI + sliderPosProportional * M_PI * 1.5, true);
+		knobValueOutline.clear();
+		juce::PathStrokeType(4.0).createStrokedPath(knobValueOutline, arcPath1);
+	}
 	g.setColour(juce::Colour(0x66, 0x66, 0xCC));
-	g.strokePath(arcPath1, juce::PathStrokeType(4.0));//»æÖÆ£¬ÕâÀï²ÅÊÇÉèÖÃÏß¿í
-	g.setColour(juce::Colour(0x33, 0x33, 0x66));
-	g.strokePath(arcPath2, juce::PathStrokeType(4.0));
+	g.fillPath(knobValueOutline);
 
 	g.setColour(juce::Colour(0x22, 0xff, 0x22));//»­ÂÌÉ«µÄÏß
 	float rotx = -sin(M_PI / 4 + sliderPosProportional * M_PI * 1.5), roty = cos(M_PI / 4 + sliderPosProportional * M_PI * 1.5);
@@ -392,6 +414,12 @@ LMButton::LMButton()
 LMButton::~LMButton()
 {
 	button.setLookAndFeel(nullptr);
+	ParamLinker = nullptr;
+}
+
+void LMButton::ParamLink(juce::AudioProcessorValueTreeState& stateToUse, const juce::String& parameterID)
+{
+	ParamLinker = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(stateToUse, parameterID, button);
 }
 
 void LMButton::setName(juce::String ButtonName)
@@ -454,6 +482,12 @@ LMCombox::LMCombox()
 LMCombox::~LMCombox()
 {
 	comboBox.setLookAndFeel(nullptr);
+	ParamLinker = nullptr;
+}
+
+void LMCombox::ParamLink(juce::AudioProcessorValueTreeState& stateToUse, const juce::String& parameterID)
+{
+	ParamLinker = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(stateToUse, parameterID, comboBox);
 }
 
 void LMCombox::addItem(juce::String name, int ID)
@@ -49,6 +49,13 @@ public:
 	void drawPopupMenuBackground(juce::Graphics& g, int width, int height) override;//»­²Ëµ¥¿ò¿ò
 
 private:
+	//ÐýÅ¥µÄ»º´æ£ºÕûÈ¦µÄ°µÉ«¹ìµÀ°´³ß´çºÍËõ·ÅÔ¤ÏÈ»­³ÉÍ¼£¬
+	//ÊýÖµ»¡ÏßÃè±ßºóµÄÂÖÀªÒ»Ö±Áô×Å£¬ÊýÖµ»ò³ß´ç±äÁË²ÅÖØËã
+	juce::Image knobTrackImage;
+	juce::Rectangle<int> knobTrackBounds;
+	float knobTrackScale = 0.0f;
+	juce::Path knobValueOutline;
+	float knobValuePos = -1.0f;
 };// Enhanced Custom1_Slider class
 class Custom1_Slider : public juce::Slider
 {
@@ -128,7 +135,7 @@ private:
     // Mouse event handlers
     void labelClicked();
 
-    void LMKnob::showRightClickMenu(const juce::Point<int>& position);  // Changed to take MouseEvent directly
+    void showRightClickMenu(const juce::Point<int>& position);  // Changed to take MouseEvent directly
 
     juce::String paramDescription = "No description.";
 };
@@ -146,8 +153,10 @@ public:
 	void buttonClicked(juce::Button* clicked) override;
 	void setClickedCallback(std::function<void()> cbFunc);
 	int getButtonState();
+	void ParamLink(juce::AudioProcessorValueTreeState& stateToUse, const juce::String& parameterID);//°ó¶¨µ½Ò»¸ö bool ²ÎÊý
 private:
 	std::unique_ptr<L_MODEL_STYLE> L_MODEL_STYLE_LOOKANDFEEL;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> ParamLinker;
 	// juce::TextButton button; // ´¿°´Å¥
 	juce::ToggleButton button; // ¿ª¹Ø
 	juce::String name;
@@ -165,9 +174,11 @@ public:
 	void setPos(int x, int y);
 	void setComboxWidth(int ComboxWidth);
 	void resized() override;
+	void ParamLink(juce::AudioProcessorValueTreeState& stateToUse, const juce::String& parameterID);//°ó¶¨µ½Ò»¸ö choice ²ÎÊý£¬ÏÈ¼ÓºÃÑ¡ÏîÔÙ°ó
 
 private:
 	std::unique_ptr<L_MODEL_STYLE> L_MODEL_STYLE_LOOKANDFEEL;
+	std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> ParamLinker;
 	juce::ComboBox comboBox;
 	int Width = 64;
 
@@ -2,11 +2,45 @@
 
 #include <JuceHeader.h>
 
-// 1. ̳ juce::Timer ʵֶѭ
-class SingleMeterUI : public juce::Component, public juce::Timer
+// Լܶʱɱ༭ VBlankAttachment ÿ֡ AdvanceFrame
+class SingleMeterUI : public juce::Component
 {
 private:
-	// ... ԭеĻͼ drawSingleMeter ֲ ...
+	// ƽĽԤȻͼǰߴŻ棬paint ʱƽһȥ
+	// ֻгߴ硢šɫ˲
+	juce::Image barImage;
+	float barImageScale = 0.0f;
+
+	void UpdateBarImage(float scale)
+	{
+		if (barImage.isValid() && barImageScale == scale) return;
+		barImageScale = scale;
+
+		int w = getWidth(), h = getHeight();
+		int iw = juce::roundToInt(w * scale), ih = juce::roundToInt(h * scale);
+		if (iw <= 0 || ih <= 0)
+		{
+			barImage = juce::Image();
+			return;
+		}
+		barImage = juce::Image(juce::Image::ARGB, iw, ih, true);
+		juce::Graphics ig(barImage);
+		ig.addTransform(juce::AffineTransform::scale(scale));
+		if (isFromTop)
+		{
+			ig.setGradientFill(juce::ColourGradient(
+				meterColor.withBrightness(0.8f), 0, 0,
+				meterColor.withBrightness(1.0f), 0, (float)h, false));
+		}
+		else
+		{
+			ig.setGradientFill(juce::ColourGradient(
+				meterColor.withBrightness(0.5f), 0, (float)h,
+				meterColor.withBrightness(1.0f), 0, 0, false));
+		}
+		ig.fillRoundedRectangle(1.0f, 0.0f, (float)w - 2, (float)h, 1.0f);
+	}
+
 	void drawSingleMeter(juce::Graphics& g, int x, int y, int width, int height,
 		float value, float peakValue, float minDb, float maxDb, juce::Colour color, bool fromTop = false)
 	{
@@ -20,27 +54,19 @@ private:
 		float normalizedPeak = juce::jlimit(0.0f, 1.0f, (peakValue - minDb) / (maxDb - minDb));
 		if (fromTop) normalizedPeak = 1.0f - normalizedPeak;
 
-		// Ƶƽ
-		if (levelHeight > 0)
+		// Ƶƽӻͼﰴزóƽһ
+		float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+		UpdateBarImage(scale);
+		if (levelHeight > 0 && barImage.isValid())
 		{
-			juce::ColourGradient gradient;
-			if (fromTop)
+			int ih = barImage.getHeight();
+			int levelPx = juce::jlimit(0, ih, juce::roundToInt(levelHeight * scale));
+			int top = fromTop ? 0 : ih - levelPx;
+			if (levelPx > 0)
 			{
-				gradient = juce::ColourGradient(
-					color.withBrightness(0.8f), x, y,
-					color.withBrightness(1.0f), x, y + height, false
-				);
-				g.setGradientFill(gradient);
-				g.fillRoundedRectangle((float)x + 1, (float)y, (float)width - 2, levelHeight, 1.0f);
-			}
-			else
-			{
-				gradient = juce::ColourGradient(
-					color.withBrightness(0.5f), x, y + height,
-					color.withBrightness(1.0f), x, y, false
-				);
-				g.setGradientFill(gradient);
-				g.fillRoundedRectangle((float)x + 1, (float)y + height - levelHeight, (float)width - 2, levelHeight, 1.0f);
+				auto strip = barImage.getClippedImage(juce::Rectangle<int>(0, top, barImage.getWidth(), levelPx));
+				g.drawImageTransformed(strip, juce::AffineTransform::translation(0.0f, (float)top)
+					.scaled(1.0f / scale).translated((float)x, (float)y));
 			}
 		}
 
@@ -65,24 +91,41 @@ private:
 
 	// --- Peak Hold صı ---
 	juce::int64 lastPeakUpdateTime = 0; // ¼һηֵµʱ
+	juce::int64 lastFrameTime = 0;      // һ֡ʱ䰴ʵʾʱ
 	const int holdTimeMs = 1000;        // ֵʱ䣺1000 (1)
-	const float decayRate = 0.75f;       // ٶȣÿ֡dB (60Hzˢ)
+	const float decayRate = 0.75f * 60.0f / 1000.0f; // ٶȣÿdB (ԭ60Hzÿ֡0.75dB)
 
-public:
-	SingleMeterUI()
+	// һλĵƽԵͷֵλ()ֻػ˵һ
+	float drawnLevelY = -1.0f;
+	float drawnPeakY = -1.0f;
+
+	float ValueToY(float value) const
 	{
-		// ʱ60Hz (ÿ60֡) ƽĵ䶯
-		startTimerHz(60);
+		float h = (float)getHeight();
+		float normalized = juce::jlimit(0.0f, 1.0f, (value - minValue) / (maxValue - minValue));
+		return isFromTop ? (1.0f - normalized) * h : h - normalized * h;
 	}
 
-	~SingleMeterUI() override
+	void RepaintSpan(float y0, float y1, float margin)
 	{
-		stopTimer();
+		if (y0 > y1) std::swap(y0, y1);
+		int top = (int)std::floor(y0 - margin);
+		int bottom = (int)std::ceil(y1 + margin);
+		repaint(0, top, getWidth(), bottom - top);
+	}
+
+public:
+	SingleMeterUI()
+	{
+		setOpaque(true);// Լػʱ
 	}
 
 	void SetColor(juce::Colour newColor)
 	{
+		if (meterColor == newColor) return;
 		meterColor = newColor;
+		barImage = juce::Image();
+		repaint();
 	}
 
 	void SetValueAndRange(float newValue, float minV = -60, float maxV = 6)
@@ -118,40 +161,51 @@ public:
 			isFromTop = fromTop;
 			peakValue = isFromTop ? maxValue : minValue;
 			currentValue = peakValue; 
+			barImage = juce::Image();
+			repaint();
 		}
 	}
 
-	void timerCallback() override
+	// ÿʾ֡һΣƽֵ䣬ֻѱ仯ΪҪػ
+	void AdvanceFrame(juce::int64 now)
 	{
-		auto now = juce::Time::getMillisecondCounter();
+		juce::int64 elapsed = lastFrameTime == 0 ? 0 : juce::jlimit<juce::int64>(0, 100, now - lastFrameTime);
+		lastFrameTime = now;
+
 		if (now > lastPeakUpdateTime + holdTimeMs)
 		{
 			if (isFromTop)
 			{
 				if (peakValue < currentValue)
 				{
-					peakValue += decayRate; 
+					peakValue += decayRate * elapsed;
 					if (peakValue > currentValue)
 						peakValue = currentValue;
-
-					repaint();
 				}
 			}
 			else
 			{
 				if (peakValue > currentValue)
 				{
-					peakValue -= decayRate; 
+					peakValue -= decayRate * elapsed;
 					if (peakValue < currentValue)
 						peakValue = currentValue;
-
-					repaint();
 				}
 			}
 		}
-		if (std::abs(peakValue - currentValue) > 0.001f)
+
+		float levelY = ValueToY(currentValue);
+		float peakY = ValueToY(peakValue);
+		if (std::abs(levelY - drawnLevelY) >= 0.25f)
 		{
-			repaint();
+			RepaintSpan(levelY, drawnLevelY < 0 ? levelY : drawnLevelY, 2.0f);
+			drawnLevelY = levelY;
+		}
+		if (std::abs(peakY - drawnPeakY) >= 0.25f)
+		{
+			RepaintSpan(peakY, peakY, 2.0f);
+			if (drawnPeakY >= 0) RepaintSpan(drawnPeakY, drawnPeakY, 2.0f);
+			drawnPeakY = peakY;
 		}
 	}
 
@@ -163,4 +217,10 @@ public:
 		drawSingleMeter(g, 0, 0, (int)w, (int)h, currentValue, peakValue,
 			minValue, maxValue, meterColor, isFromTop);
 	}
+
+	void resized() override
+	{
+		drawnLevelY = drawnPeakY = -1.0f;
+		barImage = juce::Image();
+	}
 };
\ No newline at end of file